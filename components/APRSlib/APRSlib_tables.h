@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef APRSLIB_TABLES_H_
+#define APRSLIB_TABLES_H_
+
+#include <stdint.h>
+
+#include "crc-ccit.h"
+#include "rs.h"
+
+// Constant tables generated at build time by tools/gen_tables.py into APRSlib_tables.c
+// Tables are placed in flash/rodata. Configurations not covered by a table are calculated at run time, with the same formulas.
+
+#define TONE_MAX_N 32 // longest correlator, samples per symbol
+
+// Sliding DFT oscillator table length limit
+// The table must cover a whole number of periods of both tones, that is fs / gcd(fs, markFreq, spaceFreq) samples
+// (48 for Bell 202 and 300 Bd, 96 for V.23, 192 for tones offset by a multiple of 50 Hz).
+// If the tones need a longer table, the reference correlator is used instead
+#define TONE_SDFT_MAX_PERIOD 192
+
+#define DAC_SINE_LEN 512 // DAC sine period in samples, sin_table holds the first quarter
+
+/**
+ * @brief Tone detector coefficients for one mark/space pair
+ */
+typedef struct ToneSet_s {
+    float markFreq;
+    float spaceFreq;
+    float baudRate; // baudrate the correlators are calculated for
+    int16_t coeffHiI[TONE_MAX_N], coeffLoI[TONE_MAX_N], coeffHiQ[TONE_MAX_N], coeffLoQ[TONE_MAX_N];                                  // correlator IQ coefficients, 32-bit aligned
+    int16_t sdftHiI[TONE_SDFT_MAX_PERIOD], sdftLoI[TONE_SDFT_MAX_PERIOD], sdftHiQ[TONE_SDFT_MAX_PERIOD], sdftLoQ[TONE_SDFT_MAX_PERIOD]; // sliding DFT oscillator tables
+    uint8_t N;           // samples per symbol, correlator length
+    uint8_t sdftPeriod;  // sliding DFT oscillator table length, 0 if not usable
+    int32_t surveyMark;  // 2 cos(2 pi markFreq / fs) in Q14, Goertzel coefficient for the pre-selector
+    int32_t surveySpace; // 2 cos(2 pi spaceFreq / fs) in Q14
+} tone_set_t;
+
+/**
+ * @brief Polyphase filter of the resampler for one sample rate pair
+ */
+typedef struct ResamplerTable_s {
+    uint32_t inputRate;    // input sample rate in Hz
+    uint32_t outputRate;   // output sample rate in Hz
+    uint16_t up;           // interpolation factor L
+    uint16_t down;         // decimation factor M
+    uint8_t taps;          // taps per branch
+    const int16_t *coeffs; // up branches of taps coefficients, oldest sample first
+} resampler_table_t;
+
+// HDLC deframer step, 8 received bits (NRZI decoded) at once, see ax25_rx_byte_parse()
+// Steps are indexed by the number of ones received before the byte (0 to 7, 7 meaning 7 or more) and the byte, bit 0 received first.
+// Eight bits hold at most one flag or abort, preceded and followed by data bits. Only a flag at bit 0
+// can be followed by a second event, a flag (shared zero) or an abort at bit 7.
+#define HDLC_STEP_FLAG       0x01 // flag after the head bits
+#define HDLC_STEP_ABORT      0x02 // 7 or more ones after the head bits
+#define HDLC_STEP_TAIL_FLAG  0x04 // flag after the tail bits
+#define HDLC_STEP_TAIL_ABORT 0x08 // 7 ones after the tail bits
+
+typedef struct HdlcStep_s {
+    uint8_t head;   // data bits before the first event, stuffed zeros removed, first received in bit 0
+    uint8_t tail;   // data bits between the first and the second event
+    uint8_t counts; // head bit count in bits 0-3, tail bit count in bits 4-7
+    uint8_t events; // HDLC_STEP_* in bits 0-3, number of ones at the end of the byte (0 to 7) in bits 4-6
+} hdlc_step_t;
+
+extern const tone_set_t tone_tables[];                                // default tones of every modem, at the demodulator sample rate
+extern const uint8_t tone_table_count;
+extern const resampler_table_t resampler_tables[];                    // common sound card sample rates to the demodulator sample rates
+extern const uint8_t resampler_table_count;
+extern const lwfecrs_t fx25_rs16;                                     // FX.25 Reed-Solomon generators for 16, 32 and 64 parity bytes
+extern const lwfecrs_t fx25_rs32;
+extern const lwfecrs_t fx25_rs64;
+extern const uint8_t sin_table[DAC_SINE_LEN / 4];                     // DAC sine, 0 to 255
+extern const uint8_t bit_reverse_table[256];                          // byte with the bit order reversed
+extern const hdlc_step_t hdlc_step_table[8 * 256];                    // HDLC deframer steps
+extern const uint16_t crc_ccit_slice_table[CRC_CCIT_SLICES - 1][256]; // CRC-CCITT of a byte followed by 1 to CRC_CCIT_SLICES - 1 zero bytes
+
+#endif /* APRSLIB_TABLES_H_ */
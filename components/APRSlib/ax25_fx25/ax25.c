@@ -26,13 +26,18 @@
  *
  */
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "APRSlib_port.h"
+#include "APRSlib_tables.h"
 #include "crc-ccit.h"
 #include "ax25.h"
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "frame_store.h"
 #include "modem.h"
 #ifdef ENABLE_FX25
 #include "fx25.h"
@@ -40,16 +45,13 @@
 
 static const char *TAG = "ax25";
 
-#define FRAME_MAX_COUNT                (5)                                     // max count of frames in buffer
-#define FRAME_BUFFER_SIZE              (FRAME_MAX_COUNT * AX25_FRAME_MAX_SIZE) // circular frame buffer length
-#define STATIC_HEADER_FLAG_COUNT       4                                       // number of flags sent before each frame
-#define STATIC_FOOTER_FLAG_COUNT       1                                       // number of flags sent after each frame
-#define MAX_TRANSMIT_RETRY_COUNT       8                                       // max number of retries if channel is busy
-#define SYNC_BYTE                      0x7E                                    // preamble/postamble octet
-#define GET_FREE_SIZE(max, head, tail) (((head) < (tail)) ? ((tail) - (head)) : ((max) - (head) + (tail)))
-#define GET_USED_SIZE(max, head, tail) (max - GET_FREE_SIZE(max, head, tail))
-#define _BV(bit)                       (1U << (bit))
-#define countof(a)                     sizeof(a) / sizeof(a[0])
+#define STATIC_HEADER_FLAG_COUNT 4           // number of flags sent before each frame
+#define STATIC_FOOTER_FLAG_COUNT 1           // number of flags sent after each frame
+#define MAX_TRANSMIT_RETRY_COUNT 8           // max number of retries if channel is busy
+#define SYNC_BYTE                0x7E        // preamble/postamble octet
+#define MULTIPLEX_DELAY_BITS     (4 + 2 * 8) // frame hold time for the other decoders in bits, they hand bits over a byte at a time
+#define _BV(bit)                 (1U << (bit))
+#define countof(a)               sizeof(a) / sizeof(a[0])
 #define MIN(a, b)                                                                                                                                              \
     ({                                                                                                                                                         \
         typeof(a) _a = (a);                                                                                                                                    \
@@ -70,6 +72,15 @@ static const char *TAG = "ax25";
         }                                                                                                                                                      \
     } while (0)
 
+// frame size classes of a frame being received: a decoder reserves the smallest one and moves to the next one when the frame outgrows it,
+// so typical 60 to 120-byte APRS frames do not hold AX25_FRAME_MAX_SIZE bytes of the RX store while being received
+static const uint16_t rxFrameClass[] = {64, 128, 192, AX25_FRAME_MAX_SIZE};
+#define RX_FRAME_CLASS_COUNT (sizeof(rxFrameClass) / sizeof(rxFrameClass[0]))
+
+// frame size classes of the TX pool, FX.25 blocks of up to 255 bytes fit in the largest one
+static const uint16_t txFrameClass[] = {128, 192, AX25_FRAME_MAX_SIZE};
+#define TX_FRAME_CLASS_COUNT (sizeof(txFrameClass) / sizeof(txFrameClass[0]))
+
 #define CRC_CCIT_INIT_VAL ((uint16_t)0xFFFF)
 #define HDLC_FLAG         0x7E
 #define HDLC_RESET        0x7F
@@ -94,8 +105,7 @@ typedef enum TxInitStage_e { //
     TX_INIT_TRANSMITTING     //
 } tx_init_stage_t;
 
-typedef struct FrameHandle_s {
-    uint16_t start;
+typedef struct FrameHandle_s { // frame in a frame store span: metadata followed by data
     uint16_t size;
     int8_t peak;
     int8_t valley;
@@ -105,15 +115,19 @@ typedef struct FrameHandle_s {
 #ifdef ENABLE_FX25
     struct Fx25Mode *fx25Mode;
 #endif
+    uint8_t data[];
 } frame_handle_t;
 
 typedef struct RxState_s {
     uint16_t crc;                       // current CRC
-    uint8_t frame[AX25_FRAME_MAX_SIZE]; // raw frame buffer
+    frame_handle_t *frame;              // frame being received in place in a reserved span, NULL if none
+    uint8_t frameClass;                 // size class of the reserved span, see rxFrameClass
+    uint8_t dropFrame;                  // no space in the RX store for this frame, drop it up to the next flag
     uint16_t frameIdx;                  // index for raw frame buffer
-    uint8_t receivedByte;               // byte being currently received
+    uint8_t receivedByte;               // byte being currently received, first bit in bit 0
     uint8_t receivedBitIdx;             // bit index for recByte
     uint8_t rawData;                    // raw data being currently received
+    uint8_t ones;                       // number of consecutive ones received, 7 meaning 7 or more
     ax25_rxstage_t rx;                  // current RX stage
     uint8_t frameReceived;              // frame received flag
 #ifdef ENABLE_FX25
@@ -122,26 +136,32 @@ typedef struct RxState_s {
 #endif
 } rxstate_t;
 
+struct Ax25Rx_s {
+    const modem_ctx_t *modem;                             // modem context feeding this receiver
+    rxstate_t state[MODEM_MAX_DEMODULATOR_COUNT];         // HDLC decoder for each demodulator
+    uint16_t lastCrc;                                     // CRC of the last received frame. If not 0, a frame was successfully received
+    uint16_t multiplexDelay;                              // simple delay for decoder multiplexer to avoid receiving the same frame twice
+    modem_demod_mask_t frameReceived;                     // a bitmap of receivers that received the frame
+    uint32_t frames[MODEM_MAX_DEMODULATOR_COUNT];         // count of frames received by each decoder
+    uint32_t uniqueFrames[MODEM_MAX_DEMODULATOR_COUNT];   // count of frames received by this decoder only
+    frame_handle_t *readFrame;                            // frame returned by ax25_rx_read_next_frame(), released by its next call
+    frame_store_t store;                                  // received frames and frames being received, each in one contiguous span
+    uint8_t buffer[AX25_RX_STORE_SIZE];                   // frame store memory
+};
+
 extern ax25ctx_t AX25;
 
-static uint8_t rxBuffer[FRAME_BUFFER_SIZE]; // circular buffer for received frames
-static uint16_t rxBufferHead = 0;           // circular RX buffer write index
-static frame_handle_t rxFrame[FRAME_MAX_COUNT];
-static uint8_t rxFrameHead = 0;
-static uint8_t rxFrameTail = 0;
-static bool rxFrameBufferFull = false;
-static uint8_t txBuffer[FRAME_BUFFER_SIZE]; // circular TX frame buffer
-static uint16_t txBufferHead = 0;           // circular TX buffer write index
-static uint16_t txBufferTail = 0;
-static frame_handle_t txFrame[FRAME_MAX_COUNT];
-static uint8_t txFrameHead = 0;
-static uint8_t txFrameTail = 0;
-static bool txFrameBufferFull = false;
+static ax25_rx_t defaultRx;                  // receiver of the default modem context
+static uint8_t txBuffer[AX25_TX_STORE_SIZE]; // TX frame pool memory
+static frame_pool_t txPool;                  // frames to transmit, each in a slot of its size class
+static frame_mpsc_t txQueue;                 // frames to transmit in order, from any task to the bit pump
+static _Atomic uint32_t txCommits;           // number of frames queued for transmission
+static _Atomic uint32_t txQueueFailures;     // number of frames refused because the queue was full
+static _Atomic uint32_t txQueuedPeak;        // most frames waiting at once
+static frame_handle_t *txFrame = NULL;       // frame being transmitted
 #ifdef ENABLE_FX25
-static uint8_t txFx25Buffer[FX25_MAX_BLOCK_SIZE];
 static uint8_t txTagByteIdx = 0;
 #endif
-static uint8_t frameReceived;        // a bitmap of receivers that received the frame
 static uint8_t txByte = 0;           // current TX byte
 static uint16_t txByteIdx = 0;       // current TX byte index
 static int8_t txBitIdx = 0;          // current bit index in txByte
@@ -155,35 +175,101 @@ static unsigned long txQuiet = 0;    // quit time + current tick value
 static uint8_t txRetries = 0;        // number of TX retries
 static tx_init_stage_t txInitStage; // current TX initialization stage
 static tx_stage_t txStage;           // current TX stage
-static rxstate_t rxState[MODEM_MAX_DEMODULATOR_COUNT];
-static uint16_t lastCrc = 0;          // CRC of the last received frame. If not 0, a frame was successfully received
-static uint16_t rxMultiplexDelay = 0; // simple delay for decoder multiplexer to avoid receiving the same frame twice
 static uint16_t txDelay;              // number of TXDelay bytes to send
 static uint16_t txTail;               // number of TXTail bytes to send
-static uint8_t outputFrameBuffer[AX25_FRAME_MAX_SIZE];
 
 ax25_callback_t _hook;
 
 /**
- * @brief Recalculate CRC for one bit
- * @param bit Input bit
- * @param *crc CRC pointer
+ * @brief Queue a filled TX frame for the bit pump, from any task
+ * @param *h Frame allocated from the TX pool
+ * @return False if the queue is full, the frame is freed then
  */
-static void calculateCRC(uint8_t bit, uint16_t *crc) {
-    uint16_t xor_result;
-    xor_result = *crc ^ bit;
-    *crc >>= 1;
-    if (xor_result & 0x0001) {
-        *crc ^= 0x8408;
+static bool txQueueFrame(frame_handle_t *h) {
+    if (!frame_mpsc_push(&txQueue, h)) {
+        frame_pool_free(&txPool, h);
+        atomic_fetch_add_explicit(&txQueueFailures, 1, memory_order_relaxed);
+        return false;
     }
+
+    uint32_t count = frame_mpsc_count(&txQueue);
+    uint32_t peak = atomic_load_explicit(&txQueuedPeak, memory_order_relaxed);
+    atomic_fetch_add_explicit(&txCommits, 1, memory_order_relaxed);
+    while ((count > peak) && !atomic_compare_exchange_weak_explicit(&txQueuedPeak, &peak, count, memory_order_relaxed, memory_order_relaxed))
+        ;
+    return true;
+}
+
+/**
+ * @brief Get the frame being transmitted, take the next one from the TX queue if there is none
+ * @return Frame or NULL if there is nothing to transmit
+ */
+static frame_handle_t *txCurrentFrame(void) {
+    if (txFrame == NULL)
+        txFrame = frame_mpsc_pop(&txQueue);
+    return txFrame;
+}
+
+/**
+ * @brief Give the transmitted frame back to the TX pool
+ */
+static void txFrameDone(void) {
+    frame_pool_free(&txPool, txFrame);
+    txFrame = NULL;
+    txByteIdx = 0;
 }
 
-uint8_t ax25_get_received_frame_bitmap(void) {
-    return frameReceived;
+modem_demod_mask_t ax25_get_received_frame_bitmap(void) {
+    return defaultRx.frameReceived;
 }
 
 void ax25_clear_received_frame_bitmap(void) {
-    frameReceived = 0;
+    defaultRx.frameReceived = 0;
+}
+
+modem_demod_mask_t ax25_rx_get_received_frame_bitmap(const ax25_rx_t *rx) {
+    return rx->frameReceived;
+}
+
+void ax25_rx_clear_received_frame_bitmap(ax25_rx_t *rx) {
+    rx->frameReceived = 0;
+}
+
+void ax25_get_decoder_stats(uint8_t modem, uint32_t *frames, uint32_t *unique) {
+    ax25_rx_get_decoder_stats(&defaultRx, modem, frames, unique);
+}
+
+void ax25_rx_get_decoder_stats(const ax25_rx_t *rx, uint8_t modem, uint32_t *frames, uint32_t *unique) {
+    *frames = rx->frames[modem];
+    *unique = rx->uniqueFrames[modem];
+}
+
+void ax25_rx_clear_decoder_stats(ax25_rx_t *rx) {
+    memset(rx->frames, 0, sizeof(rx->frames));
+    memset(rx->uniqueFrames, 0, sizeof(rx->uniqueFrames));
+}
+
+void ax25_rx_get_store_stats(const ax25_rx_t *rx, frame_store_stats_t *stats) {
+    frame_store_get_stats(&rx->store, stats);
+}
+
+void ax25_rx_clear_store_stats(ax25_rx_t *rx) {
+    frame_store_clear_stats(&rx->store);
+}
+
+void ax25_get_tx_store_stats(frame_store_stats_t *stats) {
+    frame_pool_get_stats(&txPool, stats);
+    stats->queued = frame_mpsc_count(&txQueue);
+    stats->queuedPeak = atomic_load_explicit(&txQueuedPeak, memory_order_relaxed);
+    stats->commits = atomic_load_explicit(&txCommits, memory_order_relaxed);
+    stats->failures += atomic_load_explicit(&txQueueFailures, memory_order_relaxed);
+}
+
+void ax25_clear_tx_store_stats(void) {
+    frame_pool_clear_stats(&txPool);
+    atomic_store_explicit(&txQueuedPeak, frame_mpsc_count(&txQueue), memory_order_relaxed);
+    atomic_store_explicit(&txCommits, 0, memory_order_relaxed);
+    atomic_store_explicit(&txQueueFailures, 0, memory_order_relaxed);
 }
 
 /*
@@ -276,15 +362,6 @@ void ax25_decode(uint8_t *buf, size_t len, uint16_t mVrms, ax25msg_t *msg) {
 }
 
 #ifdef ENABLE_FX25
-static void removeLastFrameFromRxBuffer(void) {
-    rxBufferHead = rxFrame[rxFrameHead].start;
-    if (rxFrameHead == 0)
-        rxFrameHead = FRAME_MAX_COUNT - 1;
-    else
-        rxFrameHead--;
-    rxFrameBufferFull = false;
-}
-
 static void *writeFx25Frame(uint8_t *data, uint16_t size) {
     // first calculate how big the frame can be
     // this includes 2 flags, 2 CRC bytes and all bits added by bitstuffing
@@ -298,23 +375,23 @@ static void *writeFx25Frame(uint8_t *data, uint16_t size) {
     else
         return NULL; // frame will not fit in FX.25
 
-    uint16_t freeSize = GET_FREE_SIZE(FRAME_BUFFER_SIZE, txBufferHead, txBufferTail);
-    if (freeSize < requiredSize) // check if there is enough size to store full FX.25 (or AX.25) frame
+    frame_handle_t *h = frame_pool_alloc(&txPool, sizeof(frame_handle_t) + requiredSize);
+    if (h == NULL) // check if there is enough size to store full FX.25 (or AX.25) frame
     {
         return NULL; // if not, it may fit in standard AX.25
     }
 
-    txFrame[txFrameHead].size = requiredSize;
-    txFrame[txFrameHead].start = txBufferHead;
-    txFrame[txFrameHead].fx25Mode = (struct Fx25Mode *)fx25Mode;
+    h->size = requiredSize;
+    h->fx25Mode = (struct Fx25Mode *)fx25Mode;
 
-    memset(txFx25Buffer, 0, sizeof(txFx25Buffer));
+    uint8_t *txFx25Buffer = h->data; // the block is encoded in place
+    memset(txFx25Buffer, 0, requiredSize);
 
     uint16_t index = 0;
     // header flag
     txFx25Buffer[index++] = 0x7E;
 
-    uint16_t crc = 0xFFFF;
+    uint16_t crc = update_crc_ccit_block(data, size, CRC_CCIT_INIT_VAL);
 
     uint8_t bits = 0; // bit counter within a byte
     uint8_t bitstuff = 0;
@@ -325,11 +402,9 @@ static void *writeFx25Frame(uint8_t *data, uint16_t size) {
             if (i < size) // frame data
             {
                 if ((data[i] >> k) & 1) {
-                    calculateCRC(1, &crc);
                     bitstuff++;
                     txFx25Buffer[index] |= 0x80;
                 } else {
-                    calculateCRC(0, &crc);
                     bitstuff = 0;
                 }
             } else // crc
@@ -383,30 +458,17 @@ static void *writeFx25Frame(uint8_t *data, uint16_t size) {
 
     Fx25Encode(txFx25Buffer, fx25Mode);
 
-    for (uint16_t i = 0; i < (fx25Mode->K + fx25Mode->T); i++) {
-        txBuffer[txBufferHead++] = txFx25Buffer[i];
-        txBufferHead %= FRAME_BUFFER_SIZE;
-    }
-
-    void *ret = &txFrame[txFrameHead];
-    txFrameHead++;
-    txFrameHead %= FRAME_MAX_COUNT;
-    if (txFrameHead == txFrameTail)
-        txFrameBufferFull = true;
-    return ret;
+    if (!txQueueFrame(h))
+        return NULL;
+    return h;
 }
 
-static struct FrameHandle *parseFx25Frame(uint8_t *frame, uint16_t size, uint16_t *crc) {
-    struct FrameHandle *h = &rxFrame[rxFrameHead];
-    uint16_t initialRxBufferHead = rxBufferHead;
-    if (!rxFrameBufferFull) {
-        rxFrame[rxFrameHead++].start = rxBufferHead;
-        rxFrameHead %= FRAME_MAX_COUNT;
-        if (rxFrameHead == txFrameHead)
-            rxFrameBufferFull = true;
-    } else
+static frame_handle_t *parseFx25Frame(ax25_rx_t *rx, uint8_t *frame, uint16_t size, uint16_t *crc) {
+    frame_handle_t *h = frame_store_reserve(&rx->store, sizeof(frame_handle_t) + AX25_FRAME_MAX_SIZE);
+    if (h == NULL)
         return NULL;
 
+    uint8_t *out = h->data;
     uint16_t i = 0; // input data index
     uint16_t k = 0; // output data size
     while (frame[i] == 0x7E)
@@ -414,11 +476,11 @@ static struct FrameHandle *parseFx25Frame(uint8_t *frame, uint16_t size, uint16_
 
     uint8_t bitstuff = 0;
     uint8_t outBit = 0;
-    for (; i < size; i++) {
+    for (; (i < size) && (k < AX25_FRAME_MAX_SIZE); i++) {
         for (uint8_t b = 0; b < 8; b++) {
             if (frame[i] & (1 << b)) {
-                rxBuffer[rxBufferHead] >>= 1;
-                rxBuffer[rxBufferHead] |= 0x80;
+                out[k] >>= 1;
+                out[k] |= 0x80;
                 bitstuff++;
             } else {
                 if (bitstuff == 5) // zero after 5 ones, normal bitstuffing
@@ -430,60 +492,49 @@ static struct FrameHandle *parseFx25Frame(uint8_t *frame, uint16_t size, uint16_
                     goto endParseFx25Frame;
                 } else if (bitstuff >= 7) // zero after 7 ones, illegal byte
                 {
-                    removeLastFrameFromRxBuffer();
+                    frame_store_rollback(&rx->store, h);
                     return NULL;
                 }
                 bitstuff = 0;
-                rxBuffer[rxBufferHead] >>= 1;
+                out[k] >>= 1;
             }
             outBit++;
             if (outBit == 8) {
-                k++;
-                rxBufferHead++;
-                rxBufferHead %= FRAME_BUFFER_SIZE;
                 outBit = 0;
+                if (++k == AX25_FRAME_MAX_SIZE)
+                    break;
             }
         }
     }
 
 endParseFx25Frame:
-    *crc = 0xFFFF;
-    i = initialRxBufferHead;
-
-    for (uint16_t j = 0; j < (k - 2); j++) {
-        for (uint8_t b = 0; b < 8; b++)
-            calculateCRC((rxBuffer[i] >> b) & 1, crc);
-
-        i++;
-        i %= FRAME_BUFFER_SIZE;
+    if (k < 2) // not even a CRC
+    {
+        frame_store_rollback(&rx->store, h);
+        return NULL;
     }
 
-    *crc ^= 0xFFFF;
-    if ((rxBuffer[i] == (*crc & 0xFF)) && (rxBuffer[(i + 1) % FRAME_BUFFER_SIZE] == ((*crc >> 8) & 0xFF))) // check CRC
+    *crc = update_crc_ccit_block(out, k - 2, CRC_CCIT_INIT_VAL) ^ 0xFFFF;
+    if ((out[k - 2] == (*crc & 0xFF)) && (out[k - 1] == ((*crc >> 8) & 0xFF))) // check CRC
     {
-        uint16_t pathEnd = initialRxBufferHead;
-        for (uint16_t j = 0; j < (k - 2); j++) {
-            if (rxBuffer[pathEnd] & 1)
+        uint16_t pathEnd = 0;
+        for (; pathEnd < (k - 2); pathEnd++) {
+            if (out[pathEnd] & 1)
                 break;
-            pathEnd++;
-            pathEnd %= FRAME_BUFFER_SIZE;
         }
 
-        if (Ax25Config.allowNonAprs || (((rxBuffer[(pathEnd + 1) % FRAME_BUFFER_SIZE] == 0x03) && (rxBuffer[(pathEnd + 2) % FRAME_BUFFER_SIZE] == 0xF0)))) {
+        if (Ax25Config.allowNonAprs || (((out[pathEnd + 1] == 0x03) && (out[pathEnd + 2] == 0xF0)))) {
             h->size = k - 2;
-            return h;
+            return h; // committed by the caller
         }
     }
 
-    removeLastFrameFromRxBuffer();
+    frame_store_rollback(&rx->store, h);
     return NULL;
 }
 #endif
 
 void *ax25_write_tx_frame(uint8_t *data, uint16_t size) {
-    if (txFrameBufferFull)
-        return NULL;
-
 #ifdef ENABLE_FX25
     if (Ax25Config.fx25 && Ax25Config.fx25Tx) {
         void *ret = writeFx25Frame(data, size);
@@ -492,79 +543,306 @@ void *ax25_write_tx_frame(uint8_t *data, uint16_t size) {
     }
 #endif
 
-    if (GET_FREE_SIZE(FRAME_BUFFER_SIZE, txBufferHead, txBufferTail) < size) {
+    frame_handle_t *h = frame_pool_alloc(&txPool, sizeof(frame_handle_t) + size);
+    if (h == NULL)
         return NULL;
-    }
-
-    txFrame[txFrameHead].size = size;
-    txFrame[txFrameHead].start = txBufferHead;
 
+    h->size = size;
 #ifdef ENABLE_FX25
-    txFrame[txFrameHead].fx25Mode = NULL;
+    h->fx25Mode = NULL;
 #endif
+    memcpy(h->data, data, size);
 
-    for (uint16_t i = 0; i < size; i++) {
-        txBuffer[txBufferHead++] = data[i];
-        txBufferHead %= FRAME_BUFFER_SIZE;
-    }
-
-    void *ret = &txFrame[txFrameHead];
-    //__disable_irq();
-    txFrameHead++;
-    txFrameHead %= FRAME_MAX_COUNT;
-    if (txFrameHead == txFrameTail)
-        txFrameBufferFull = true;
-    //__enable_irq();
-    return ret;
+    if (!txQueueFrame(h))
+        return NULL;
+    return h;
 }
 
 bool ax25_read_next_rx_frame(uint8_t **dst, uint16_t *size, int8_t *peak, int8_t *valley, uint8_t *level, uint8_t *corrected, uint16_t *mV) {
-    if ((rxFrameHead == rxFrameTail) && !rxFrameBufferFull)
-        return false;
+    return ax25_rx_read_next_frame(&defaultRx, dst, size, peak, valley, level, corrected, mV);
+}
 
-    *dst = outputFrameBuffer;
+bool ax25_rx_read_next_frame(ax25_rx_t *rx, uint8_t **dst, uint16_t *size, int8_t *peak, int8_t *valley, uint8_t *level, uint8_t *corrected,
+                             uint16_t *mV) {
+    ax25_rx_frame_t frame;
 
-    for (uint16_t i = 0; i < rxFrame[rxFrameTail].size; i++) {
-        (*dst)[i] = rxBuffer[(rxFrame[rxFrameTail].start + i) % FRAME_BUFFER_SIZE];
+    if (rx->readFrame != NULL) { // the frame read last time is not used any more
+        frame_store_release(&rx->store, rx->readFrame);
+        rx->readFrame = NULL;
     }
 
-    *peak = rxFrame[rxFrameTail].peak;
-    *valley = rxFrame[rxFrameTail].valley;
-    *level = rxFrame[rxFrameTail].level;
-    *size = rxFrame[rxFrameTail].size;
-    *corrected = rxFrame[rxFrameTail].corrected;
-    *mV = rxFrame[rxFrameTail].mVrms;
+    if (!ax25_rx_lease_frame(rx, &frame))
+        return false;
+
+    rx->readFrame = frame.handle;
+    *dst = rx->readFrame->data;
+    *peak = frame.peak;
+    *valley = frame.valley;
+    *level = frame.level;
+    *size = frame.size;
+    *corrected = frame.corrected;
+    *mV = frame.mVrms;
+
+    return true;
+}
+
+bool ax25_lease_rx_frame(ax25_rx_frame_t *frame) {
+    return ax25_rx_lease_frame(&defaultRx, frame);
+}
 
-    rxFrameBufferFull = false;
-    rxFrameTail++;
-    rxFrameTail %= FRAME_MAX_COUNT;
+void ax25_release_rx_frame(const ax25_rx_frame_t *frame) {
+    ax25_rx_release_frame(&defaultRx, frame);
+}
+
+bool ax25_rx_lease_frame(ax25_rx_t *rx, ax25_rx_frame_t *frame) {
+    frame_handle_t *h = frame_store_take(&rx->store, NULL);
+    if (h == NULL)
+        return false;
 
+    frame->data = h->data;
+    frame->size = h->size;
+    frame->peak = h->peak;
+    frame->valley = h->valley;
+    frame->level = h->level;
+    frame->corrected = h->corrected;
+    frame->mVrms = h->mVrms;
+    frame->handle = h;
     return true;
 }
 
+void ax25_rx_release_frame(ax25_rx_t *rx, const ax25_rx_frame_t *frame) {
+    frame_store_release(&rx->store, frame->handle);
+}
+
 ax25_rxstage_t ax25_get_rx_stage(uint8_t modem) {
-    return rxState[modem].rx;
+    return defaultRx.state[modem].rx;
+}
+
+ax25_rxstage_t ax25_rx_get_stage(const ax25_rx_t *rx, uint8_t modem) {
+    return rx->state[modem].rx;
 }
 
 void ax25_bit_parse(uint8_t bit, uint8_t modem, uint16_t mV) {
-    if (lastCrc != 0) // there was a frame received
+    ax25_rx_bit_parse(&defaultRx, bit, modem, mV);
+}
+
+/**
+ * @brief Decoder multiplexer: release the frame held for the other decoders after a while
+ * @param *ax25 AX.25 receiver
+ * @param bits Number of bits handed over by the calling decoder
+ */
+static void rxMultiplex(ax25_rx_t *ax25, uint8_t bits) {
+    if (ax25->lastCrc != 0) // there was a frame received
     {
-        rxMultiplexDelay++;
-        if (rxMultiplexDelay > (4 * MODEM_MAX_DEMODULATOR_COUNT)) // hold it for a while and wait for other decoders to receive the frame
+        ax25->multiplexDelay += bits;
+        if (ax25->multiplexDelay > (MULTIPLEX_DELAY_BITS * modem_ctx_get_demodulator_count(ax25->modem))) // hold it for a while and wait for other decoders to receive the frame
         {
-            lastCrc = 0;
-            rxMultiplexDelay = 0;
+            modem_demod_mask_t received = 0;
+
+            ax25->lastCrc = 0;
+            ax25->multiplexDelay = 0;
             for (uint8_t i = 0; i < MODEM_MAX_DEMODULATOR_COUNT; i++) {
-                frameReceived |= ((rxState[i].frameReceived > 0) << i);
-                rxState[i].frameReceived = 0;
+                received |= ((modem_demod_mask_t)(ax25->state[i].frameReceived > 0) << i);
+                ax25->state[i].frameReceived = 0;
             }
+            ax25->frameReceived |= received;
+
+            for (uint8_t i = 0; i < MODEM_MAX_DEMODULATOR_COUNT; i++) { // decoder statistics, to tell which demodulators pay off
+                if (received & ((modem_demod_mask_t)1 << i)) {
+                    ax25->frames[i]++;
+                    if (received == ((modem_demod_mask_t)1 << i))
+                        ax25->uniqueFrames[i]++;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief HDLC flag received: check and store the frame received so far and wait for the next one
+ * @param *ax25 AX.25 receiver
+ * @param *rx Decoder state
+ * @param modem Modem/decoder number
+ * @param mV Input signal RMS level in mV
+ */
+static void rxFlag(ax25_rx_t *ax25, rxstate_t *rx, uint8_t modem, uint16_t mV) {
+    if (rx->rx == RX_STAGE_FRAME) // if we are in frame, this is the end of the frame
+    {
+        if (rx->frameIdx >= 17) // correct frame must be at least 17 bytes long (source+destination+control+CRC)
+        {
+            const uint8_t *frame = rx->frame->data;
+
+            rx->crc ^= 0xFFFF;
+            if ((frame[rx->frameIdx - 2] == (rx->crc & 0xFF)) && (frame[rx->frameIdx - 1] == ((rx->crc >> 8) & 0xFF))) // check CRC
+            {
+                uint16_t i = 13;
+                // start from 13, which is the SSID of source
+                for (; i < (rx->frameIdx - 2); i++) // look for path end bit
+                {
+                    if (frame[i] & 1)
+                        break;
+                }
+
+                // if non-APRS frames are not allowed, check if this frame has control=0x03 and PID=0xF0
+                if (Ax25Config.allowNonAprs || (((frame[i + 1] == 0x03) && (frame[i + 2] == 0xF0)))) {
+
+                    rx->frameReceived = 1;
+                    rx->frameIdx -= 2;            // remove CRC
+                    if (rx->crc != ax25->lastCrc) // the other decoder has not received this frame yet, so commit its span to the frame queue
+                    {
+                        frame_handle_t *h = rx->frame;
+
+                        ax25->lastCrc = rx->crc; // store CRC of this frame
+
+                        h->mVrms = mV;
+                        modem_ctx_get_signal_level(ax25->modem, modem, &h->peak, &h->valley, &h->level);
+#ifdef ENABLE_FX25
+                        h->fx25Mode = NULL;
+#endif
+                        h->corrected = AX25_NOT_FX25;
+                        h->size = rx->frameIdx;
+                        frame_store_commit(&ax25->store, h, sizeof(frame_handle_t) + h->size);
+                        rx->frame = NULL;
+                    }
+                }
+            }
+        }
+    }
+    if (rx->frame != NULL) // not committed, roll back
+    {
+        frame_store_rollback(&ax25->store, rx->frame);
+        rx->frame = NULL;
+    }
+    rx->dropFrame = 0;
+    rx->rx = RX_STAGE_FLAG;
+    rx->receivedByte = 0;
+    rx->receivedBitIdx = 0;
+    rx->frameIdx = 0;
+    rx->crc = 0xFFFF;
+}
+
+/**
+ * @brief 7 consecutive ones received, this is an error: drop the frame
+ * @param *ax25 AX.25 receiver
+ * @param *rx Decoder state
+ */
+static void rxAbort(ax25_rx_t *ax25, rxstate_t *rx) {
+    if (rx->frame != NULL) {
+        frame_store_rollback(&ax25->store, rx->frame);
+        rx->frame = NULL;
+    }
+    rx->rx = RX_STAGE_IDLE;
+    rx->receivedByte = 0;
+    rx->receivedBitIdx = 0;
+    rx->frameIdx = 0;
+    rx->crc = 0xFFFF;
+}
+
+/**
+ * @brief Store a received byte in the frame
+ * @param *ax25 AX.25 receiver
+ * @param *rx Decoder state
+ * @param byte Received byte
+ * @param modem Modem/decoder number
+ */
+static void rxByte(ax25_rx_t *ax25, rxstate_t *rx, uint8_t byte, uint8_t modem) {
+    if (rx->frame == NULL) // first byte of a frame, reserve a span of the smallest class to receive it in place
+    {
+        if (rx->dropFrame)
+            return;
+        rx->frame = frame_store_reserve(&ax25->store, sizeof(frame_handle_t) + rxFrameClass[0]);
+        rx->frameClass = 0;
+        if (rx->frame == NULL) // store full, drop this frame
+        {
+            rxAbort(ax25, rx);
+            rx->dropFrame = 1;
+            return;
         }
+    } else if ((rx->frameIdx == rxFrameClass[rx->frameClass]) && (rx->frameClass < (RX_FRAME_CLASS_COUNT - 1))) // span full, grow it to the next class
+    {
+        frame_handle_t *h = frame_store_grow(&ax25->store, rx->frame, sizeof(frame_handle_t) + rxFrameClass[rx->frameClass + 1],
+                                             sizeof(frame_handle_t) + rx->frameIdx);
+        if (h == NULL) // store full, drop this frame
+        {
+            rxAbort(ax25, rx);
+            rx->dropFrame = 1;
+            return;
+        }
+        rx->frame = h;
+        rx->frameClass++;
     }
 
-    rxstate_t *rx = (rxstate_t *)&(rxState[modem]);
+    uint8_t *frame = rx->frame->data;
+
+    if (rx->frameIdx >= 2) // the last 2 bytes may be the CRC
+        rx->crc = update_crc_ccit(frame[rx->frameIdx - 2], rx->crc);
+
+#ifdef ENABLE_FX25
+    // end of FX.25 reception, that is received full block
+    if ((rx->fx25Mode != NULL) && (rx->frameIdx == (rx->fx25Mode->K + rx->fx25Mode->T))) {
+        uint8_t fixed = 0;
+        bool fecSuccess = Fx25Decode(frame, rx->fx25Mode, &fixed);
+        uint16_t crc;
+        frame_handle_t *h = parseFx25Frame(ax25, frame, rx->frameIdx, &crc); // decoded into another span, the raw block is rolled back
+        if (h != NULL) {
+            rx->frameReceived = 1;
+            modem_ctx_get_signal_level(ax25->modem, modem, &h->peak, &h->valley, &h->level);
+            if (fecSuccess) {
+                h->corrected = fixed;
+                h->fx25Mode = rx->fx25Mode;
+            } else
+                h->corrected = AX25_NOT_FX25;
+            frame_store_commit(&ax25->store, h, sizeof(frame_handle_t) + h->size);
+            ax25->lastCrc = crc;
+        }
+        frame_store_rollback(&ax25->store, rx->frame);
+        rx->frame = NULL;
+        rx->rx = RX_STAGE_FLAG;
+        rx->frameIdx = 0;
+        return;
+    }
+#else
+    (void)modem;
+#endif
+    if (rx->frameIdx >= AX25_FRAME_MAX_SIZE) // frame is too long
+    {
+        rxAbort(ax25, rx);
+        return;
+    }
+    frame[rx->frameIdx++] = byte; // store received byte
+}
+
+/**
+ * @brief Add received data bits (bit stuffing removed) to the frame
+ * @param *ax25 AX.25 receiver
+ * @param *rx Decoder state
+ * @param bits Data bits, first received in bit 0
+ * @param count Number of bits, 1 to 8
+ * @param modem Modem/decoder number
+ */
+static inline void rxData(ax25_rx_t *ax25, rxstate_t *rx, uint8_t bits, uint8_t count, uint8_t modem) {
+    uint16_t data = rx->receivedByte | ((uint16_t)bits << rx->receivedBitIdx);
+
+    rx->rx = RX_STAGE_FRAME;
+    rx->receivedBitIdx += count;
+    if (rx->receivedBitIdx >= 8) // received full byte, at most one as count is at most 8
+    {
+        rx->receivedBitIdx -= 8;
+        rx->receivedByte = (uint8_t)(data >> 8);
+        rxByte(ax25, rx, (uint8_t)data, modem); // last, as dropping the frame clears the partial byte
+        return;
+    }
+    rx->receivedByte = (uint8_t)data;
+}
+
+void ax25_rx_bit_parse(ax25_rx_t *ax25, uint8_t bit, uint8_t modem, uint16_t mV) {
+    rxMultiplex(ax25, 1);
+
+    rxstate_t *rx = &ax25->state[modem];
 
     rx->rawData <<= 1; // store incoming bit
     rx->rawData |= (bit > 0);
+    rx->ones = (bit > 0) ? ((rx->ones < 7) ? (rx->ones + 1) : 7) : 0;
 
 #ifdef ENABLE_FX25
     rx->tag >>= 1;
@@ -576,6 +854,7 @@ void ax25_bit_parse(uint8_t bit, uint8_t modem, uint16_t mV) {
         rx->receivedByte = 0;
         rx->receivedBitIdx = 0;
         rx->frameIdx = 0;
+        rx->dropFrame = 0;
         return;
     }
 
@@ -585,134 +864,59 @@ void ax25_bit_parse(uint8_t bit, uint8_t modem, uint16_t mV) {
 
     if (rx->rawData == 0x7E) // HDLC flag received
     {
-        if (rx->rx == RX_STAGE_FRAME) // if we are in frame, this is the end of the frame
-        {
-            if (rx->frameIdx >= 17) // correct frame must be at least 17 bytes long (source+destination+control+CRC)
-            {
-                rx->crc ^= 0xFFFF;
-                if ((rx->frame[rx->frameIdx - 2] == (rx->crc & 0xFF)) && (rx->frame[rx->frameIdx - 1] == ((rx->crc >> 8) & 0xFF))) // check CRC
-                {
-                    uint16_t i = 13;
-                    // log_i(TAG,"[%i]%s",rx->frameIdx,rx->frame);
-                    // start from 13, which is the SSID of source
-                    for (; i < (rx->frameIdx - 2); i++) // look for path end bit
-                    {
-                        if (rx->frame[i] & 1)
-                            break;
-                    }
-
-                    // if non-APRS frames are not allowed, check if this frame has control=0x03 and PID=0xF0
-                    if (Ax25Config.allowNonAprs || (((rx->frame[i + 1] == 0x03) && (rx->frame[i + 2] == 0xF0)))) {
-
-                        rx->frameReceived = 1;
-                        rx->frameIdx -= 2;      // remove CRC
-                        if (rx->crc != lastCrc) // the other decoder has not received this frame yet, so store it in main frame buffer
-                        {
-                            lastCrc = rx->crc; // store CRC of this frame
-
-                            if (!rxFrameBufferFull) // if enough space, store the frame
-                            {
-                                rxFrame[rxFrameHead].start = rxBufferHead;
-                                rxFrame[rxFrameHead].mVrms = mV;
-                                modem_get_signal_level(modem, &rxFrame[rxFrameHead].peak, &rxFrame[rxFrameHead].valley, &rxFrame[rxFrameHead].level);
-#ifdef ENABLE_FX25
-                                rxFrame[rxFrameHead].fx25Mode = NULL;
-#endif
-                                rxFrame[rxFrameHead].corrected = AX25_NOT_FX25;
-
-                                rxFrame[rxFrameHead++].size = rx->frameIdx;
-                                rxFrameHead %= FRAME_MAX_COUNT;
-                                if (rxFrameHead == rxFrameTail)
-                                    rxFrameBufferFull = true;
-
-                                for (uint16_t i = 0; i < rx->frameIdx; i++) {
-                                    rxBuffer[rxBufferHead++] = rx->frame[i];
-                                    rxBufferHead %= FRAME_BUFFER_SIZE;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        rx->rx = RX_STAGE_FLAG;
-        rx->receivedByte = 0;
-        rx->receivedBitIdx = 0;
-        rx->frameIdx = 0;
-        rx->crc = 0xFFFF;
+        rxFlag(ax25, rx, modem, mV);
         return;
-    } else
-        rx->rx = RX_STAGE_FRAME;
+    }
 
 #ifndef ENABLE_FX25
+    // this condition must not be checked when FX.25 is enabled
+    // because FX.25 parity bytes and tags contain >= 7 consecutive ones
+    if ((rx->rawData & 0x7F) == 0x7F) // received 7 consecutive ones, this is an error
     {
-        // this condition must not be checked when FX.25 is enabled
-        // because FX.25 parity bytes and tags contain >= 7 consecutive ones
-        if ((rx->rawData & 0x7F) == 0x7F) // received 7 consecutive ones, this is an error
-        {
-            rx->rx = RX_STAGE_IDLE;
-            rx->receivedByte = 0;
-            rx->receivedBitIdx = 0;
-            rx->frameIdx = 0;
-            rx->crc = 0xFFFF;
-            return;
-        }
+        rxAbort(ax25, rx);
+        return;
+    }
 #endif
-        if ((rx->rawData & 0x3F) == 0x3E) // dismiss bit 0 added by bit stuffing
-            return;
+    if ((rx->rawData & 0x3F) == 0x3E) // dismiss bit 0 added by bit stuffing
+    {
+        rx->rx = RX_STAGE_FRAME;
+        return;
     }
 
-    if (rx->rawData & 0x01)       // received bit 1
-        rx->receivedByte |= 0x80; // store it
-
-    if (++rx->receivedBitIdx >= 8) // received full byte
-    {
-        if (rx->frameIdx >= 2) {
-            for (uint8_t k = 0; k < 8; k++) {
-                calculateCRC((rx->frame[rx->frameIdx - 2] >> k) & 1, &(rx->crc));
-            }
-        }
+    rxData(ax25, rx, (bit > 0), 1, modem);
+}
 
+void ax25_rx_byte_parse(ax25_rx_t *ax25, uint8_t bits, uint8_t modem, uint16_t mV) {
 #ifdef ENABLE_FX25
-        // end of FX.25 reception, that is received full block
-        if ((rx->fx25Mode != NULL) && (rx->frameIdx == (rx->fx25Mode->K + rx->fx25Mode->T))) {
-            uint8_t fixed = 0;
-            bool fecSuccess = Fx25Decode(rx->frame, rx->fx25Mode, &fixed);
-            uint16_t crc;
-            struct FrameHandle *h = parseFx25Frame(rx->frame, rx->frameIdx, &crc);
-            if (h != NULL) {
-                rx->frameReceived = 1;
-                ModemGetSignalLevel(modem, &h->peak, &h->valley, &h->level);
-                if (fecSuccess) {
-                    h->corrected = fixed;
-                    h->fx25Mode = rx->fx25Mode;
-                } else
-                    h->corrected = AX25_NOT_FX25;
-                lastCrc = crc;
-            }
-            rx->rx = RX_STAGE_FLAG;
-            rx->receivedByte = 0;
-            rx->receivedBitIdx = 0;
-            rx->frameIdx = 0;
-            return;
-        }
+    for (uint8_t i = 0; i < 8; i++) // FX.25 correlation tags are searched for at every bit
+        ax25_rx_bit_parse(ax25, (bits >> i) & 1, modem, mV);
 #else
-    rx->rx = RX_STAGE_FRAME;
+    rxMultiplex(ax25, 8);
+
+    rxstate_t *rx = &ax25->state[modem];
+    const hdlc_step_t *step = &hdlc_step_table[((uint16_t)rx->ones << 8) | bits]; // flags, aborts and stuffed zeros of all 8 bits
+    uint8_t headCount = step->counts & 0x0F;
+    uint8_t tailCount = step->counts >> 4;
+
+    rx->rawData = bit_reverse_table[bits]; // the last bit received is bit 0
+    rx->ones = (step->events >> 4) & 0x07;
+
+    if (headCount)
+        rxData(ax25, rx, step->head, headCount, modem);
+
+    if (step->events & HDLC_STEP_FLAG)
+        rxFlag(ax25, rx, modem, mV);
+    else if (step->events & HDLC_STEP_ABORT)
+        rxAbort(ax25, rx);
+
+    if (tailCount)
+        rxData(ax25, rx, step->tail, tailCount, modem);
+
+    if (step->events & HDLC_STEP_TAIL_FLAG)
+        rxFlag(ax25, rx, modem, mV);
+    else if (step->events & HDLC_STEP_TAIL_ABORT)
+        rxAbort(ax25, rx);
 #endif
-        if (rx->frameIdx >= AX25_FRAME_MAX_SIZE) // frame is too long
-        {
-            rx->rx = RX_STAGE_IDLE;
-            rx->receivedByte = 0;
-            rx->receivedBitIdx = 0;
-            rx->frameIdx = 0;
-            rx->crc = 0xFFFF;
-            return;
-        }
-        rx->frame[rx->frameIdx++] = rx->receivedByte; // store received byte
-        rx->receivedByte = 0;
-        rx->receivedBitIdx = 0;
-    } else
-        rx->receivedByte >>= 1;
 }
 
 uint8_t ax25_get_tx_bit(void) {
@@ -726,7 +930,7 @@ uint8_t ax25_get_tx_bit(void) {
             } else {
                 txDelayElapsed = 0;
 #ifdef ENABLE_FX25
-                if (NULL != txFrame[txFrameTail].fx25Mode) {
+                if ((txCurrentFrame() != NULL) && (NULL != txFrame->fx25Mode)) {
                     txStage = TX_STAGE_CORRELATION_TAG;
                     txTagByteIdx = 0;
                 } else
@@ -739,7 +943,7 @@ uint8_t ax25_get_tx_bit(void) {
         if (txStage == TX_STAGE_CORRELATION_TAG) // FX.25 correlation tag
         {
             if (txTagByteIdx < 8)
-                txByte = (txFrame[txFrameTail].fx25Mode->tag >> (8 * txTagByteIdx)) & 0xFF;
+                txByte = (txFrame->fx25Mode->tag >> (8 * txTagByteIdx)) & 0xFF;
             else
                 txStage = TX_STAGE_DATA;
 
@@ -759,21 +963,22 @@ uint8_t ax25_get_tx_bit(void) {
         if (txStage == TX_STAGE_DATA) // transmitting normal data
         {
         transmitNormalData:
-            if ((txFrameHead != txFrameTail) || txFrameBufferFull) {
-                if (txByteIdx < txFrame[txFrameTail].size) // send buffer
+            if (txCurrentFrame() != NULL) {
+                if (txByteIdx < txFrame->size) // send buffer
                 {
-                    txByte = txBuffer[(txFrame[txFrameTail].start + txByteIdx) % FRAME_BUFFER_SIZE];
+                    txByte = txFrame->data[txByteIdx];
                     txByteIdx++;
+#ifdef ENABLE_FX25
+                    if (NULL == txFrame->fx25Mode) // FX.25 blocks carry the CRC already
+#endif
+                        txCrc = update_crc_ccit(txByte, txCrc);
                 }
 #ifdef ENABLE_FX25
-                else if (txFrame[txFrameTail].fx25Mode != NULL) {
-                    txFrameBufferFull = false;
-                    txFrameTail++;
-                    txFrameTail %= FRAME_MAX_COUNT;
-                    txByteIdx = 0;
-
-                    if ((txFrameHead != txFrameTail) || txFrameBufferFull) {
-                        if (txFrame[txFrameTail].fx25Mode != NULL) {
+                else if (txFrame->fx25Mode != NULL) {
+                    txFrameDone();
+
+                    if (txCurrentFrame() != NULL) {
+                        if (txFrame->fx25Mode != NULL) {
                             txStage = TX_STAGE_CORRELATION_TAG;
                             txTagByteIdx = 0;
                             goto transmitTag;
@@ -812,14 +1017,9 @@ uint8_t ax25_get_tx_bit(void) {
                 txFlagsElapsed++;
             } else {
                 txFlagsElapsed = 0;
-                //__disable_irq();
-                txFrameBufferFull = false;
-                txFrameTail++;
-                txFrameTail %= FRAME_MAX_COUNT;
-                txByteIdx = 0;
+                txFrameDone();
 #ifdef ENABLE_FX25
-                if (((txFrameHead != txFrameTail) || txFrameBufferFull) && (txFrame[txFrameTail].fx25Mode != NULL)) {
-                    //__enable_irq();
+                if ((txCurrentFrame() != NULL) && (txFrame->fx25Mode != NULL)) {
                     txStage = TX_STAGE_CORRELATION_TAG;
                     txTagByteIdx = 0;
                     goto transmitTag;
@@ -842,7 +1042,6 @@ uint8_t ax25_get_tx_bit(void) {
                 txBitstuff = 0;
                 txByte = 0;
                 txInitStage = TX_INIT_OFF;
-                txBufferTail = txBufferHead;
                 modem_transmit_stop();
                 return 0;
             }
@@ -853,7 +1052,7 @@ uint8_t ax25_get_tx_bit(void) {
     // transmitting normal data or CRC in AX.25 mode
     if (
 #ifdef ENABLE_FX25
-        (NULL == txFrame[txFrameTail].fx25Mode) &&
+        ((txFrame == NULL) || (NULL == txFrame->fx25Mode)) &&
 #endif
         ((txStage == TX_STAGE_DATA) || (txStage == TX_STAGE_CRC))) {
         if (txBitstuff == 5) // 5 consecutive ones transmitted
@@ -869,9 +1068,6 @@ uint8_t ax25_get_tx_bit(void) {
                 txBit = 0;
                 txBitstuff = 0; // 0 being transmitted, reset bit stuffing counter
             }
-            if (txStage == TX_STAGE_DATA) // calculate CRC only for normal data
-                calculateCRC(txByte & 1, &txCrc);
-
             txByte >>= 1;
             txBitIdx++;
         }
@@ -894,7 +1090,7 @@ void ax25_transmit_buffer(void) {
     if (txInitStage == TX_INIT_TRANSMITTING)
         return;
 
-    if ((txFrameHead != txFrameTail) || txFrameBufferFull) {
+    if ((txFrame != NULL) || (frame_mpsc_count(&txQueue) > 0)) {
         txQuiet = (port_millis() + (Ax25Config.quietTime) + port_random(100, 2000)); // calculate required delay
         txInitStage = TX_INIT_WAITING;
     }
@@ -965,9 +1161,14 @@ void ax25_init(uint8_t fx25Mode) {
         Ax25Config.fx25Tx = 1;
     }
 
-    memset((void *)rxState, 0, sizeof(rxState));
-    for (uint8_t i = 0; i < (sizeof(rxState) / sizeof(rxState[0])); i++)
-        rxState[i].crc = 0xFFFF;
+    ax25_rx_reset(&defaultRx, modem_get_default_ctx());
+    uint16_t txSlotSize[TX_FRAME_CLASS_COUNT];
+    for (uint8_t i = 0; i < TX_FRAME_CLASS_COUNT; i++)
+        txSlotSize[i] = sizeof(frame_handle_t) + txFrameClass[i];
+    frame_pool_init(&txPool, txBuffer, sizeof(txBuffer), txSlotSize, TX_FRAME_CLASS_COUNT);
+    frame_mpsc_init(&txQueue);
+    ax25_clear_tx_store_stats();
+    txFrame = NULL;
 
     txDelay = ((float)Ax25Config.txDelayLength / (8.f * 1000.f / modem_get_baudrate())); // change milliseconds to byte count
     txTail = ((float)Ax25Config.txTailLength / (8.f * 1000.f / modem_get_baudrate()));
@@ -1150,5 +1351,42 @@ int ax25_hdlc_frame(uint8_t *outbuf, size_t outbuf_len, ax25ctx_t *ctx, ax25fram
 }
 
 bool ax25_new_rx_frames(void) {
-    return (rxFrameHead != rxFrameTail) || rxFrameBufferFull;
+    return ax25_rx_new_frames(&defaultRx);
+}
+
+bool ax25_rx_new_frames(const ax25_rx_t *rx) {
+    return frame_store_count(&rx->store) > 0;
+}
+
+ax25_rx_t *ax25_get_default_rx(void) {
+    return &defaultRx;
+}
+
+void ax25_rx_reset(ax25_rx_t *rx, const modem_ctx_t *modem) {
+    memset(rx, 0, sizeof(*rx));
+    rx->modem = modem;
+    frame_store_init(&rx->store, rx->buffer, sizeof(rx->buffer));
+    for (uint8_t i = 0; i < MODEM_MAX_DEMODULATOR_COUNT; i++)
+        rx->state[i].crc = 0xFFFF;
+}
+
+void ax25_rx_reset_decoders(ax25_rx_t *rx, uint8_t first) {
+    for (uint8_t i = first; i < MODEM_MAX_DEMODULATOR_COUNT; i++) {
+        rxAbort(rx, &rx->state[i]); // give back the span of a frame being received
+        memset(&rx->state[i], 0, sizeof(rx->state[i]));
+        rx->state[i].crc = 0xFFFF;
+    }
+}
+
+ax25_rx_t *ax25_rx_create(const modem_ctx_t *modem) {
+    ax25_rx_t *rx = malloc(sizeof(ax25_rx_t));
+    if (rx != NULL)
+        ax25_rx_reset(rx, modem);
+
+    return rx;
+}
+
+void ax25_rx_destroy(ax25_rx_t *rx) {
+    if (rx != &defaultRx)
+        free(rx);
 }
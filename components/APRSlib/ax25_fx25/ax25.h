@@ -33,6 +33,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "frame_store.h"
+#include "modem.h"
+
 #define AX25_NOT_FX25 255
 
 // for AX.25 329 bytes is the theoretical max size assuming 2-byte Control, 1-byte PID, 256-byte info field and 8 digi address fields
@@ -45,6 +48,16 @@
 #define AX25_REPEATED(msg, n) ((msg)->rpt_flags & BV(n))
 #define CALL_OVERSPACE        1
 
+// frame memory sizes in bytes. A received frame takes its own size plus a few bytes of metadata in one contiguous span,
+// a frame being received takes a span of the smallest size class it fits in. A frame to transmit takes a slot of
+// the smallest size class it fits in. Can be overridden at build time
+#ifndef AX25_RX_STORE_SIZE
+#define AX25_RX_STORE_SIZE ((5 + MODEM_MAX_DEMODULATOR_COUNT) * AX25_FRAME_MAX_SIZE)
+#endif
+#ifndef AX25_TX_STORE_SIZE
+#define AX25_TX_STORE_SIZE (5 * AX25_FRAME_MAX_SIZE)
+#endif
+
 typedef enum Ax25RxStage_e {
     RX_STAGE_IDLE = 0,
     RX_STAGE_FLAG,
@@ -112,6 +125,19 @@ typedef struct AX25Msg_s {
     uint16_t mVrms;
 } ax25msg_t;
 
+typedef struct Ax25Rx_s ax25_rx_t; // AX.25 receiver: HDLC decoders of one modem context and its received frame buffer
+
+typedef struct Ax25RxFrame_s {
+    const uint8_t *data; // frame data in the receiver buffer, valid until the frame is released
+    uint16_t size;       // frame size without CRC
+    int8_t peak;         // signal positive peak value in %
+    int8_t valley;       // signal negative peak value in %
+    uint8_t level;       // signal level in %
+    uint8_t corrected;   // number of bytes corrected in FX.25 mode, AX25_NOT_FX25 if not a FX.25 packet
+    uint16_t mVrms;      // signal level in mV RMS
+    void *handle;        // receiver frame store span holding the frame
+} ax25_rx_frame_t;
+
 extern ax25_protoconfig_t Ax25Config;
 extern bool ax25_stateTx;
 extern int transmissionState;
@@ -120,8 +146,9 @@ extern int transmissionState;
  * @brief Write frame to transmit buffer
  * @param *data Data to transmit
  * @param size Data size
- * @return Pointer to internal frame handle or NULL on failure
- * @attention This function will block if transmission is already in progress
+ * @return Pointer to internal frame handle or NULL on failure. The frame belongs to the transmitter once queued, do not access it
+ * @attention Never blocks: returns NULL at once if no TX pool slot fits the frame or the TX queue is full
+ * @note Lock-free, may be called from several tasks at once (KISS, beacons, digipeater)
  */
 void *ax25_write_tx_frame(uint8_t *data, uint16_t size);
 
@@ -129,7 +156,7 @@ void *ax25_write_tx_frame(uint8_t *data, uint16_t size);
  * @brief Get bitmap of "frame received" flags for each decoder. A non-zero value means that a frame was received
  * @return Bitmap of decoder that received the frame
  */
-uint8_t ax25_get_received_frame_bitmap(void);
+modem_demod_mask_t ax25_get_received_frame_bitmap(void);
 
 /**
  * @brief Clear bitmap of "frame received" flags
@@ -145,17 +172,141 @@ void ax25_clear_received_frame_bitmap(void);
  * @param *level Signal level in %
  * @param *corrected Number of bytes corrected in FX.25 mode. 255 is returned if not a FX.25 packet.
  * @return True if frame was read, false if no more frames to read
+ * @attention The frame stays valid until the next call
  */
 bool ax25_read_next_rx_frame(uint8_t **dst, uint16_t *size, int8_t *peak, int8_t *valley, uint8_t *level, uint8_t *corrected, uint16_t *mV);
 
+/**
+ * @brief Get next frame received by an AX.25 receiver (if available)
+ * @param *rx AX.25 receiver, see modem_ctx_get_rx()
+ * @param **dst Pointer to receiver internal buffer
+ * @param *size Actual frame size
+ * @param *peak Signak positive peak value in %
+ * @param *valley Signal negative peak value in %
+ * @param *level Signal level in %
+ * @param *corrected Number of bytes corrected in FX.25 mode. 255 is returned if not a FX.25 packet.
+ * @return True if frame was read, false if no more frames to read
+ * @attention The frame stays valid until the next call
+ */
+bool ax25_rx_read_next_frame(ax25_rx_t *rx, uint8_t **dst, uint16_t *size, int8_t *peak, int8_t *valley, uint8_t *level, uint8_t *corrected,
+                             uint16_t *mV);
+
+/**
+ * @brief Lease next received frame (if available) without copying it
+ * @param *frame Frame descriptor, data points into the receiver buffer
+ * @return True if frame was leased, false if no more frames to read
+ * @attention The frame slot stays occupied until ax25_release_rx_frame() is called
+ */
+bool ax25_lease_rx_frame(ax25_rx_frame_t *frame);
+
+/**
+ * @brief Release a frame leased with ax25_lease_rx_frame()
+ * @param *frame Frame descriptor
+ */
+void ax25_release_rx_frame(const ax25_rx_frame_t *frame);
+
+/**
+ * @brief Lease next frame received by an AX.25 receiver (if available) without copying it
+ * @param *rx AX.25 receiver
+ * @param *frame Frame descriptor, data points into the receiver buffer
+ * @return True if frame was leased, false if no more frames to read
+ * @attention Frames can be released in any order, the receiver drops new frames while all slots are leased or queued
+ * @note Lock-free: one task may lease and release frames while another one feeds the receiver
+ */
+bool ax25_rx_lease_frame(ax25_rx_t *rx, ax25_rx_frame_t *frame);
+
+/**
+ * @brief Release a frame leased with ax25_rx_lease_frame()
+ * @param *rx AX.25 receiver
+ * @param *frame Frame descriptor
+ */
+void ax25_rx_release_frame(ax25_rx_t *rx, const ax25_rx_frame_t *frame);
+
+/**
+ * @brief Check if an AX.25 receiver has frames to read
+ * @param *rx AX.25 receiver
+ * @return True if there is at least one frame
+ */
+bool ax25_rx_new_frames(const ax25_rx_t *rx);
+
+/**
+ * @brief Get bitmap of "frame received" flags for each decoder of an AX.25 receiver
+ * @param *rx AX.25 receiver
+ * @return Bitmap of decoder that received the frame
+ */
+modem_demod_mask_t ax25_rx_get_received_frame_bitmap(const ax25_rx_t *rx);
+
+/**
+ * @brief Clear bitmap of "frame received" flags of an AX.25 receiver
+ * @param *rx AX.25 receiver
+ */
+void ax25_rx_clear_received_frame_bitmap(ax25_rx_t *rx);
+
+/**
+ * @brief Get count of frames received by a decoder
+ * @param modemNo Modem/decoder number
+ * @param *frames Number of frames received by this decoder
+ * @param *unique Number of frames received by this decoder and no other
+ */
+void ax25_get_decoder_stats(uint8_t modemNo, uint32_t *frames, uint32_t *unique);
+
+/**
+ * @brief Get count of frames received by a decoder of an AX.25 receiver
+ * @details A decoder with few unique frames adds little to the other decoders, e.g. a data slicer level that is not needed.
+ * @param *rx AX.25 receiver
+ * @param modemNo Modem/decoder number
+ * @param *frames Number of frames received by this decoder
+ * @param *unique Number of frames received by this decoder and no other
+ */
+void ax25_rx_get_decoder_stats(const ax25_rx_t *rx, uint8_t modemNo, uint32_t *frames, uint32_t *unique);
+
+/**
+ * @brief Clear decoder statistics of an AX.25 receiver
+ * @param *rx AX.25 receiver
+ */
+void ax25_rx_clear_decoder_stats(ax25_rx_t *rx);
+
+/**
+ * @brief Get frame store statistics of an AX.25 receiver: bytes and frames held at most, frames dropped for lack of space
+ * @param *rx AX.25 receiver
+ * @param *stats Statistics
+ */
+void ax25_rx_get_store_stats(const ax25_rx_t *rx, frame_store_stats_t *stats);
+
+/**
+ * @brief Clear frame store statistics of an AX.25 receiver
+ * @param *rx AX.25 receiver
+ */
+void ax25_rx_clear_store_stats(ax25_rx_t *rx);
+
+/**
+ * @brief Get TX frame pool statistics: bytes and frames held at most, frames refused for lack of a free slot or a full queue
+ * @param *stats Statistics
+ */
+void ax25_get_tx_store_stats(frame_store_stats_t *stats);
+
+/**
+ * @brief Clear TX frame pool statistics
+ */
+void ax25_clear_tx_store_stats(void);
+
 /**
  * @brief Get current RX stage
- * @param[in] modemNo Modem/decoder number (0 or 1)
+ * @param[in] modemNo Modem/decoder number
  * @return RX_STATE_IDLE, RX_STATE_FLAG or RX_STATE_FRAME
  * @warning Only for internal use
  */
 ax25_rxstage_t ax25_get_rx_stage(uint8_t modemNo);
 
+/**
+ * @brief Get current RX stage of an AX.25 receiver
+ * @param *rx AX.25 receiver
+ * @param[in] modemNo Modem/decoder number
+ * @return RX_STATE_IDLE, RX_STATE_FLAG or RX_STATE_FRAME
+ * @warning Only for internal use
+ */
+ax25_rxstage_t ax25_rx_get_stage(const ax25_rx_t *rx, uint8_t modemNo);
+
 /**
  * @brief Parse incoming bit (not symbol!)
  * @details Handles bit-stuffing, header and CRC checking, stores received frame and sets "frame received flag", multiplexes both decoders
@@ -165,6 +316,64 @@ ax25_rxstage_t ax25_get_rx_stage(uint8_t modemNo);
  */
 void ax25_bit_parse(uint8_t bit, uint8_t modem, uint16_t mV);
 
+/**
+ * @brief Parse incoming bit (not symbol!) in an AX.25 receiver
+ * @param *rx AX.25 receiver
+ * @param[in] bit Incoming bit
+ * @param[in] modem Modem/decoder number
+ * @param[in] mV Input signal RMS level in mV
+ * @warning Only for internal use
+ */
+void ax25_rx_bit_parse(ax25_rx_t *rx, uint8_t bit, uint8_t modem, uint16_t mV);
+
+/**
+ * @brief Parse 8 incoming bits (not symbols!) in an AX.25 receiver
+ * @details Same as 8 calls of ax25_rx_bit_parse(), flags, bit stuffing and aborts of all 8 bits are found with a single table lookup
+ * @param *rx AX.25 receiver
+ * @param[in] bits Incoming bits, first received in bit 0
+ * @param[in] modem Modem/decoder number
+ * @param[in] mV Input signal RMS level in mV
+ * @warning Only for internal use
+ */
+void ax25_rx_byte_parse(ax25_rx_t *rx, uint8_t bits, uint8_t modem, uint16_t mV);
+
+/**
+ * @brief Get the AX.25 receiver of the default modem context
+ * @return AX.25 receiver used by functions without a receiver argument
+ * @warning Only for internal use
+ */
+ax25_rx_t *ax25_get_default_rx(void);
+
+/**
+ * @brief Create AX.25 receiver
+ * @param *modem Modem context, used for demodulator count and signal levels
+ * @return AX.25 receiver or NULL if out of memory
+ * @warning Only for internal use, receivers are created by modem_ctx_create()
+ */
+ax25_rx_t *ax25_rx_create(const modem_ctx_t *modem);
+
+/**
+ * @brief Destroy AX.25 receiver
+ * @param *rx AX.25 receiver
+ * @warning Only for internal use
+ */
+void ax25_rx_destroy(ax25_rx_t *rx);
+
+/**
+ * @brief Clear AX.25 receiver state and drop all received frames
+ * @param *rx AX.25 receiver
+ * @param *modem Modem context feeding this receiver
+ */
+void ax25_rx_reset(ax25_rx_t *rx, const modem_ctx_t *modem);
+
+/**
+ * @brief Reset HDLC decoders that are no longer fed, e.g. after the demodulator count was lowered
+ * @details Frames being received by these decoders are dropped and their frame store spans given back, queued frames are kept.
+ * @param *rx AX.25 receiver
+ * @param first First decoder to reset, all following ones are reset too
+ */
+void ax25_rx_reset_decoders(ax25_rx_t *rx, uint8_t first);
+
 /**
  * @brief Get next bit to be transmitted
  * @return Bit to be transmitted
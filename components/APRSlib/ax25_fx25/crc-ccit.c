@@ -1,3 +1,4 @@
+#include "APRSlib_tables.h"
 #include "crc-ccit.h"
 
 const uint16_t crc_ccit_table[256] = {
@@ -15,4 +16,23 @@ const uint16_t crc_ccit_table[256] = {
     0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232, 0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a, 0xe70e, 0xf687, 0xc41c, 0xd595,
     0xa12a, 0xb0a3, 0x8238, 0x93b1, 0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9, 0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9,
     0x8330, 0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78,
-};
\ No newline at end of file
+};
+
+uint16_t update_crc_ccit_block(const uint8_t *data, size_t len, uint16_t prev_crc) {
+    const uint16_t(*t)[256] = crc_ccit_slice_table; // t[n - 1]: byte followed by n zero bytes
+    uint16_t crc = prev_crc;
+
+    for (; len >= CRC_CCIT_SLICES; len -= CRC_CCIT_SLICES, data += CRC_CCIT_SLICES) {
+        crc ^= data[0] | ((uint16_t)data[1] << 8);
+#if CRC_CCIT_SLICES == 8
+        crc = t[6][crc & 0xff] ^ t[5][crc >> 8] ^ t[4][data[2]] ^ t[3][data[3]] ^ t[2][data[4]] ^ t[1][data[5]] ^ t[0][data[6]] ^ crc_ccit_table[data[7]];
+#else
+        crc = t[2][crc & 0xff] ^ t[1][crc >> 8] ^ t[0][data[2]] ^ crc_ccit_table[data[3]];
+#endif
+    }
+
+    while (len--)
+        crc = update_crc_ccit(*data++, crc);
+
+    return crc;
+}
@@ -4,21 +4,35 @@
 #define CRC_CCIT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define CRC_CCIT_INIT_VAL ((uint16_t)0xFFFF)
 
+// bytes per step of update_crc_ccit_block() for long buffers, 4 or 8
+// slice-by-N needs N - 1 tables of 512 bytes besides crc_ccit_table, see APRSlib_tables.h
+#define CRC_CCIT_SLICES 8
+
+#if (CRC_CCIT_SLICES != 4) && (CRC_CCIT_SLICES != 8)
+#error "CRC_CCIT_SLICES must be 4 or 8"
+#endif
+
 extern const uint16_t crc_ccit_table[256];
 
-inline uint16_t update_crc_ccit(uint8_t c, uint16_t prev_crc) {
+static inline uint16_t update_crc_ccit(uint8_t c, uint16_t prev_crc) {
     return (prev_crc >> 8) ^ crc_ccit_table[(prev_crc ^ c) & 0xff];
 }
 
+/*
+ * Same as update_crc_ccit() for every byte of a buffer, CRC_CCIT_SLICES bytes per step (slice-by-N).
+ */
+uint16_t update_crc_ccit_block(const uint8_t *data, size_t len, uint16_t prev_crc);
+
 /*
  * Use this for an AX.25 frame.
  */
 
-inline uint16_t fcs_calc(unsigned char *data, int len) {
+static inline uint16_t fcs_calc(unsigned char *data, int len) {
     uint16_t crc = 0xffff;
     int j;
 
@@ -30,7 +44,7 @@ inline uint16_t fcs_calc(unsigned char *data, int len) {
     return (crc ^ 0xffff);
 }
 
-inline unsigned short crc16(unsigned char *data, int len, unsigned short seed) {
+static inline unsigned short crc16(unsigned char *data, int len, unsigned short seed) {
     unsigned short crc = seed;
     int j;
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_pool.h"
+
+#define ALIGN_UP(x) (((x) + FRAME_STORE_ALIGN - 1) & ~(FRAME_STORE_ALIGN - 1)) // round up to the slot alignment
+
+/**
+ * @brief Claim the lowest free slot of a class
+ * @param *fp Frame pool
+ * @param c Class index
+ * @return Slot data or NULL if the class is full
+ */
+static void *claimSlot(frame_pool_t *fp, uint8_t c) {
+    uint32_t free = atomic_load_explicit(&fp->cls[c].free, memory_order_relaxed);
+
+    while (free != 0) {
+        uint32_t bit = free & -free;
+        // acquire pairs with the release in frame_pool_free(), the previous owner is done with the slot
+        if (atomic_compare_exchange_weak_explicit(&fp->cls[c].free, &free, free & ~bit, memory_order_acquire, memory_order_relaxed))
+            return fp->cls[c].base + (uint32_t)__builtin_ctz(bit) * fp->cls[c].size;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Account for slot bytes taken or given back
+ * @param *fp Frame pool
+ * @param delta Bytes taken (positive) or given back (negative)
+ */
+static void addUsed(frame_pool_t *fp, int32_t delta) {
+    uint32_t used = atomic_fetch_add_explicit(&fp->used, (uint32_t)delta, memory_order_relaxed) + (uint32_t)delta;
+    uint32_t peak = atomic_load_explicit(&fp->usedPeak, memory_order_relaxed);
+
+    while ((used > peak) && !atomic_compare_exchange_weak_explicit(&fp->usedPeak, &peak, used, memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+void frame_pool_init(frame_pool_t *fp, void *buffer, size_t size, const uint16_t *classSize, uint8_t classes) {
+    size_t pad = ALIGN_UP((uintptr_t)buffer) - (uintptr_t)buffer;
+    uint8_t *next = (uint8_t *)buffer + pad;
+
+    size = (size > pad) ? (size - pad) : 0;
+    if (size > UINT16_MAX)
+        size = UINT16_MAX;
+    if (classes > FRAME_POOL_MAX_CLASSES)
+        classes = FRAME_POOL_MAX_CLASSES;
+
+    fp->classes = classes;
+    fp->capacity = 0;
+    for (int8_t c = classes - 1; c >= 0; c--) // largest class first, the smallest one takes what is left
+    {
+        uint16_t slot = ALIGN_UP(classSize[c]);
+        size_t share = (c > 0) ? (size / (c + 1)) : size;
+        size_t count = share / slot;
+
+        if ((count == 0) && (slot <= size)) // at least one slot
+            count = 1;
+        if (count > FRAME_POOL_MAX_PER_CLASS)
+            count = FRAME_POOL_MAX_PER_CLASS;
+
+        fp->cls[c].base = next;
+        fp->cls[c].size = slot;
+        fp->cls[c].count = (uint8_t)count;
+        atomic_init(&fp->cls[c].free, (count < 32) ? ((1UL << count) - 1) : 0xFFFFFFFF);
+
+        next += count * slot;
+        size -= count * slot;
+        fp->capacity += count * slot;
+    }
+
+    atomic_init(&fp->used, 0);
+    atomic_init(&fp->usedPeak, 0);
+    atomic_init(&fp->failures, 0);
+}
+
+void *frame_pool_alloc(frame_pool_t *fp, uint16_t size) {
+    for (uint8_t c = 0; c < fp->classes; c++) {
+        if (size > fp->cls[c].size)
+            continue;
+        void *data = claimSlot(fp, c);
+        if (data != NULL) {
+            addUsed(fp, fp->cls[c].size);
+            return data;
+        }
+    }
+    atomic_fetch_add_explicit(&fp->failures, 1, memory_order_relaxed);
+    return NULL;
+}
+
+void frame_pool_free(frame_pool_t *fp, void *data) {
+    for (uint8_t c = 0; c < fp->classes; c++) {
+        uint32_t offset = (uint32_t)((uint8_t *)data - fp->cls[c].base);
+        if (((uint8_t *)data >= fp->cls[c].base) && (offset < ((uint32_t)fp->cls[c].count * fp->cls[c].size))) {
+            addUsed(fp, -(int32_t)fp->cls[c].size);
+            // release: all writes and reads of the slot by this owner come before the next owner claims it
+            atomic_fetch_or_explicit(&fp->cls[c].free, 1UL << (offset / fp->cls[c].size), memory_order_release);
+            return;
+        }
+    }
+}
+
+void frame_pool_get_stats(const frame_pool_t *fp, frame_store_stats_t *stats) {
+    stats->capacity = fp->capacity;
+    stats->used = atomic_load_explicit(&fp->used, memory_order_relaxed);
+    stats->usedPeak = atomic_load_explicit(&fp->usedPeak, memory_order_relaxed);
+    stats->failures = atomic_load_explicit(&fp->failures, memory_order_relaxed);
+}
+
+void frame_pool_clear_stats(frame_pool_t *fp) {
+    atomic_store_explicit(&fp->usedPeak, atomic_load_explicit(&fp->used, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&fp->failures, 0, memory_order_relaxed);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef FRAME_POOL_H_
+#define FRAME_POOL_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_store.h"
+
+#define FRAME_POOL_MAX_CLASSES   4  // most size classes in a pool
+#define FRAME_POOL_MAX_PER_CLASS 32 // most slots in a size class, one bit each in the free bitmap
+
+/**
+ * @brief Frame pool: fixed size slots in a few size classes, allocated and freed without locks
+ * @details Each size class owns a run of equal slots and a bitmap of the free ones. A slot is claimed with a compare-and-swap
+ * on the bitmap and given back with an atomic OR, so any number of contexts may allocate and free concurrently, interrupts included.
+ * A request is served from the smallest class that fits it and has a free slot.
+ */
+typedef struct FramePool_s {
+    struct {
+        uint8_t *base;         // first slot, FRAME_STORE_ALIGN aligned
+        uint16_t size;         // slot size in bytes, multiple of FRAME_STORE_ALIGN
+        uint8_t count;         // number of slots
+        _Atomic uint32_t free; // bitmap of free slots
+    } cls[FRAME_POOL_MAX_CLASSES];
+    uint8_t classes;           // number of size classes
+    uint16_t capacity;         // bytes in slots
+    _Atomic uint32_t used;     // bytes in allocated slots
+    _Atomic uint32_t usedPeak; // high-water mark of used
+    _Atomic uint32_t failures; // number of allocations that found no free slot
+} frame_pool_t;
+
+/**
+ * @brief Initialize frame pool
+ * @details Every class gets about the same share of the memory, at least one slot if it fits, the smallest class gets the rest.
+ * @param *fp Frame pool
+ * @param *buffer Memory for slots, any alignment
+ * @param size Memory size in bytes
+ * @param *classSize Largest data size of each class, ascending
+ * @param classes Number of classes, FRAME_POOL_MAX_CLASSES at most
+ */
+void frame_pool_init(frame_pool_t *fp, void *buffer, size_t size, const uint16_t *classSize, uint8_t classes);
+
+/**
+ * @brief Allocate a slot
+ * @param *fp Frame pool
+ * @param size Data size
+ * @return Slot data, FRAME_STORE_ALIGN aligned, or NULL if no class that fits has a free slot
+ */
+void *frame_pool_alloc(frame_pool_t *fp, uint16_t size);
+
+/**
+ * @brief Free a slot
+ * @param *fp Frame pool
+ * @param *data Slot data returned by frame_pool_alloc()
+ */
+void frame_pool_free(frame_pool_t *fp, void *data);
+
+/**
+ * @brief Get usage statistics: capacity, bytes used and failures. Queue fields are left alone
+ * @param *fp Frame pool
+ * @param *stats Statistics
+ */
+void frame_pool_get_stats(const frame_pool_t *fp, frame_store_stats_t *stats);
+
+/**
+ * @brief Clear usage statistics, the high-water mark restarts from the current usage
+ * @param *fp Frame pool
+ */
+void frame_pool_clear_stats(frame_pool_t *fp);
+
+#endif /* FRAME_POOL_H_ */
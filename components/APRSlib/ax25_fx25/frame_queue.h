@@ -0,0 +1,193 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef FRAME_QUEUE_H_
+#define FRAME_QUEUE_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// entries of a frame queue, a power of two. Can be overridden at build time
+#ifndef FRAME_QUEUE_LEN
+#define FRAME_QUEUE_LEN 32
+#endif
+
+#if (FRAME_QUEUE_LEN & (FRAME_QUEUE_LEN - 1)) != 0
+#error "FRAME_QUEUE_LEN must be a power of two"
+#endif
+
+/**
+ * @brief Lock-free single-producer single-consumer queue of frame pointers
+ * @details Each index is written by one side only. The producer publishes an entry, and everything it wrote to the frame
+ * before, with a release store of head; the consumer frees the entry with a release store of tail.
+ */
+typedef struct FrameSpsc_s {
+    _Atomic uint32_t head;        // number of entries pushed, written by the producer
+    _Atomic uint32_t tail;        // number of entries popped, written by the consumer
+    void *entry[FRAME_QUEUE_LEN]; // entries
+} frame_spsc_t;
+
+/**
+ * @brief Lock-free multi-producer single-consumer queue of frame pointers
+ * @details Bounded queue with a sequence number per cell (D. Vyukov): producers claim a cell with a CAS on head and
+ * publish it with a release store of its sequence number, the consumer returns it with the sequence number of the next lap.
+ * A producer preempted between the claim and the publication holds back the consumer at that cell until it is resumed.
+ */
+typedef struct FrameMpsc_s {
+    _Atomic uint32_t head; // next position claimed by producers
+    _Atomic uint32_t tail; // next position popped, written by the consumer
+    struct {
+        _Atomic uint32_t seq; // position + 1 when the entry is ready, position + FRAME_QUEUE_LEN when free for the next lap
+        void *entry;
+    } cell[FRAME_QUEUE_LEN];
+} frame_mpsc_t;
+
+/**
+ * @brief Initialize single-producer single-consumer queue
+ * @param *q Queue
+ */
+static inline void frame_spsc_init(frame_spsc_t *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+}
+
+/**
+ * @brief Push an entry, producer side
+ * @param *q Queue
+ * @param *entry Entry
+ * @return False if the queue is full
+ */
+static inline bool frame_spsc_push(frame_spsc_t *q, void *entry) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire); // the consumer is done with the entries before tail
+
+    if ((head - tail) == FRAME_QUEUE_LEN)
+        return false;
+
+    q->entry[head & (FRAME_QUEUE_LEN - 1)] = entry;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Pop the oldest entry, consumer side
+ * @param *q Queue
+ * @return Entry or NULL if the queue is empty
+ */
+static inline void *frame_spsc_pop(frame_spsc_t *q) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire); // entries and frames before head are written
+
+    if (head == tail)
+        return NULL;
+
+    void *entry = q->entry[tail & (FRAME_QUEUE_LEN - 1)];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return entry;
+}
+
+/**
+ * @brief Get number of entries, exact from either side
+ * @param *q Queue
+ * @return Number of entries
+ */
+static inline uint32_t frame_spsc_count(const frame_spsc_t *q) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return atomic_load_explicit(&q->head, memory_order_acquire) - tail;
+}
+
+/**
+ * @brief Initialize multi-producer single-consumer queue
+ * @param *q Queue
+ */
+static inline void frame_mpsc_init(frame_mpsc_t *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    for (uint32_t i = 0; i < FRAME_QUEUE_LEN; i++)
+        atomic_init(&q->cell[i].seq, i);
+}
+
+/**
+ * @brief Push an entry, from any producer
+ * @param *q Queue
+ * @param *entry Entry
+ * @return False if the queue is full
+ */
+static inline bool frame_mpsc_push(frame_mpsc_t *q, void *entry) {
+    uint32_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    for (;;) {
+        uint32_t seq = atomic_load_explicit(&q->cell[pos & (FRAME_QUEUE_LEN - 1)].seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) // cell free in this lap, claim it
+        {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) // cell of the previous lap not popped yet, full
+            return false;
+        else // another producer claimed it
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    }
+
+    q->cell[pos & (FRAME_QUEUE_LEN - 1)].entry = entry;
+    atomic_store_explicit(&q->cell[pos & (FRAME_QUEUE_LEN - 1)].seq, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Pop the oldest entry, consumer side
+ * @param *q Queue
+ * @return Entry or NULL if the queue is empty
+ */
+static inline void *frame_mpsc_pop(frame_mpsc_t *q) {
+    uint32_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t seq = atomic_load_explicit(&q->cell[pos & (FRAME_QUEUE_LEN - 1)].seq, memory_order_acquire);
+
+    if (seq != (pos + 1)) // empty, or the producer of this cell has not published it yet
+        return NULL;
+
+    void *entry = q->cell[pos & (FRAME_QUEUE_LEN - 1)].entry;
+    atomic_store_explicit(&q->cell[pos & (FRAME_QUEUE_LEN - 1)].seq, pos + FRAME_QUEUE_LEN, memory_order_release);
+    atomic_store_explicit(&q->tail, pos + 1, memory_order_release);
+    return entry;
+}
+
+/**
+ * @brief Get number of entries claimed by producers and not popped yet
+ * @param *q Queue
+ * @return Number of entries
+ */
+static inline uint32_t frame_mpsc_count(const frame_mpsc_t *q) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return atomic_load_explicit(&q->head, memory_order_acquire) - tail;
+}
+
+#endif /* FRAME_QUEUE_H_ */
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "frame_store.h"
+
+#define NO_SPAN     0xFFFF                                                     // no span offset
+#define ALIGN_UP(x) (((x) + FRAME_STORE_ALIGN - 1) & ~(FRAME_STORE_ALIGN - 1)) // round up to the span alignment
+#define HEADER_SIZE ((uint16_t)ALIGN_UP(sizeof(frame_span_t)))                 // span header size, data is aligned too
+
+typedef enum SpanState_e {
+    SPAN_FREE = 0,  // dropped by the writer, reclaimed when it reaches an end of the ring
+    SPAN_RESERVED,  // being written
+    SPAN_COMMITTED, // queued for the reader or being read
+    SPAN_RELEASED,  // released by the reader, reclaimed and accounted for by the writer when it reaches an end of the ring
+} span_state_t;
+
+typedef struct FrameSpan_s {
+    uint16_t size;         // span size, header included, multiple of FRAME_STORE_ALIGN
+    uint16_t prev;         // previous span in the buffer, NO_SPAN for the oldest one
+    uint16_t len;          // data size
+    _Atomic uint8_t state; // span_state_t, the only header field written by the reader
+} frame_span_t;
+
+static inline frame_span_t *span(const frame_store_t *fs, uint16_t offset) {
+    return (frame_span_t *)(fs->buffer + offset);
+}
+
+static inline uint16_t spanOffset(const frame_store_t *fs, const void *data) {
+    return (uint16_t)((const uint8_t *)data - fs->buffer - HEADER_SIZE);
+}
+
+/**
+ * @brief Account for span bytes taken or given back
+ * @param *fs Frame store
+ * @param delta Bytes taken (positive) or given back (negative)
+ */
+static inline void addUsed(frame_store_t *fs, int32_t delta) {
+    fs->used += delta;
+    if (fs->used > fs->usedPeak)
+        fs->usedPeak = fs->used;
+}
+
+/**
+ * @brief Check whether a span can be reclaimed, writer side
+ * @details Acquire pairs with the release in frame_store_release(), the reader is done with the span data then.
+ * @param *fs Frame store
+ * @param offset Span offset
+ * @return True if the span is free or released
+ */
+static bool reclaimable(frame_store_t *fs, uint16_t offset) {
+    uint8_t state = atomic_load_explicit(&span(fs, offset)->state, memory_order_acquire);
+
+    if (state == SPAN_RELEASED) // given back by the reader, not accounted for yet
+    {
+        atomic_store_explicit(&span(fs, offset)->state, SPAN_FREE, memory_order_relaxed);
+        addUsed(fs, -(int32_t)span(fs, offset)->size);
+        return true;
+    }
+    return state == SPAN_FREE;
+}
+
+/**
+ * @brief Forget all spans, the queue is left alone
+ * @param *fs Frame store
+ */
+static void resetRing(frame_store_t *fs) {
+    fs->head = 0;
+    fs->tail = 0;
+    fs->end = fs->capacity;
+    fs->newest = NO_SPAN;
+    fs->used = 0;
+}
+
+/**
+ * @brief Drop free spans at the write end of the ring
+ * @param *fs Frame store
+ */
+static void trimHead(frame_store_t *fs) {
+    while ((fs->newest != NO_SPAN) && reclaimable(fs, fs->newest)) {
+        fs->head = fs->newest;
+        fs->newest = span(fs, fs->newest)->prev;
+        if ((fs->head == 0) && (fs->newest != NO_SPAN)) // back over the wrap, the spans in the upper part end the ring again
+        {
+            fs->head = fs->end;
+            fs->end = fs->capacity;
+        }
+    }
+}
+
+/**
+ * @brief Drop free spans at the read end of the ring
+ * @param *fs Frame store
+ */
+static void trimTail(frame_store_t *fs) {
+    while ((fs->newest != NO_SPAN) && reclaimable(fs, fs->tail)) {
+        if (fs->tail == fs->newest) // all spans are free, none can be queued
+        {
+            resetRing(fs);
+            return;
+        }
+        fs->tail += span(fs, fs->tail)->size;
+        if (fs->tail == fs->end) // skip the unused end of the buffer
+        {
+            fs->tail = 0;
+            fs->end = fs->capacity;
+        }
+        span(fs, fs->tail)->prev = NO_SPAN;
+    }
+}
+
+/**
+ * @brief Mark a span free, writer side
+ * @param *fs Frame store
+ * @param offset Span offset
+ */
+static inline void freeSpan(frame_store_t *fs, uint16_t offset) {
+    frame_span_t *s = span(fs, offset);
+
+    atomic_store_explicit(&s->state, SPAN_FREE, memory_order_relaxed);
+    addUsed(fs, -(int32_t)s->size);
+}
+
+void frame_store_init(frame_store_t *fs, void *buffer, size_t size) {
+    size_t pad = ALIGN_UP((uintptr_t)buffer) - (uintptr_t)buffer;
+
+    size = (size > pad) ? (size - pad) : 0;
+    if (size > FRAME_STORE_MAX_SIZE)
+        size = FRAME_STORE_MAX_SIZE;
+
+    fs->buffer = (uint8_t *)buffer + pad;
+    fs->capacity = (uint16_t)(size & ~(FRAME_STORE_ALIGN - 1));
+    frame_store_clear(fs);
+    frame_store_clear_stats(fs);
+}
+
+void frame_store_clear(frame_store_t *fs) {
+    resetRing(fs);
+    frame_spsc_init(&fs->queue);
+}
+
+void *frame_store_reserve(frame_store_t *fs, uint16_t size) {
+    uint32_t need = ALIGN_UP((uint32_t)HEADER_SIZE + size);
+    uint16_t at;
+
+    trimTail(fs); // reclaim spans released since the last reservation
+    trimHead(fs);
+
+    if (fs->newest == NO_SPAN) // empty, start over at the beginning
+        resetRing(fs);
+
+    if ((fs->newest == NO_SPAN) || (fs->head > fs->tail)) // spans from tail to head
+    {
+        if (need <= (uint32_t)(fs->capacity - fs->head))
+            at = fs->head;
+        else if (need <= fs->tail) // does not fit at the end, continue at the beginning
+        {
+            fs->end = fs->head;
+            at = 0;
+        } else {
+            fs->failures++;
+            return NULL;
+        }
+    } else // wrapped, spans from tail to end and from 0 to head
+    {
+        if (need <= (uint32_t)(fs->tail - fs->head))
+            at = fs->head;
+        else {
+            fs->failures++;
+            return NULL;
+        }
+    }
+
+    frame_span_t *s = span(fs, at);
+    s->size = (uint16_t)need;
+    s->prev = fs->newest;
+    s->len = size;
+    atomic_store_explicit(&s->state, SPAN_RESERVED, memory_order_relaxed);
+
+    fs->newest = at;
+    fs->head = at + (uint16_t)need;
+    addUsed(fs, need);
+    return (uint8_t *)s + HEADER_SIZE;
+}
+
+void *frame_store_grow(frame_store_t *fs, void *data, uint16_t size, uint16_t keep) {
+    uint16_t at = spanOffset(fs, data);
+    frame_span_t *s = span(fs, at);
+    uint32_t need = ALIGN_UP((uint32_t)HEADER_SIZE + size);
+
+    if (at == fs->newest) // the space after the newest span is free up to the end of the buffer or to the oldest span
+    {
+        uint32_t limit = (fs->head > fs->tail) ? fs->capacity : fs->tail;
+        if ((at + need) <= limit) {
+            addUsed(fs, (int32_t)need - s->size);
+            s->size = (uint16_t)need;
+            s->len = size;
+            fs->head = at + (uint16_t)need;
+            return data;
+        }
+    }
+
+    uint8_t *moved = frame_store_reserve(fs, size); // move to a larger span
+    if (moved == NULL)
+        return NULL;
+    memcpy(moved, data, keep);
+    frame_store_rollback(fs, data);
+    return moved;
+}
+
+bool frame_store_commit(frame_store_t *fs, void *data, uint16_t size) {
+    uint16_t at = spanOffset(fs, data);
+    frame_span_t *s = span(fs, at);
+    uint16_t need = ALIGN_UP(HEADER_SIZE + size);
+
+    if (at == fs->newest) // give the unused end back
+    {
+        addUsed(fs, (int32_t)need - s->size);
+        s->size = need;
+        fs->head = at + need;
+    } else if ((s->size - need) >= HEADER_SIZE) // newer spans follow, leave the unused end as a free span
+    {
+        uint16_t rest = at + need;
+        uint16_t next = at + s->size;
+        if (next == fs->end)
+            next = 0;
+
+        span(fs, rest)->size = s->size - need;
+        span(fs, rest)->prev = at;
+        atomic_store_explicit(&span(fs, rest)->state, SPAN_FREE, memory_order_relaxed);
+        span(fs, next)->prev = rest;
+        addUsed(fs, (int32_t)need - s->size);
+        s->size = need;
+    }
+
+    s->len = size;
+    atomic_store_explicit(&s->state, SPAN_COMMITTED, memory_order_relaxed);
+
+    if (!frame_spsc_push(&fs->queue, data)) // publishes the span data and header to the reader
+    {
+        frame_store_rollback(fs, data);
+        fs->failures++;
+        return false;
+    }
+
+    uint16_t count = frame_store_count(fs);
+    fs->commits++;
+    if (count > fs->countPeak)
+        fs->countPeak = count;
+    return true;
+}
+
+void frame_store_rollback(frame_store_t *fs, void *data) {
+    freeSpan(fs, spanOffset(fs, data));
+    trimHead(fs);
+}
+
+void *frame_store_take(frame_store_t *fs, uint16_t *size) {
+    uint8_t *data = frame_spsc_pop(&fs->queue);
+
+    if ((data != NULL) && (size != NULL))
+        *size = span(fs, spanOffset(fs, data))->len;
+    return data;
+}
+
+void frame_store_release(frame_store_t *fs, void *data) {
+    // the writer may reuse the span as soon as it sees this store, all reads of the span must come before it
+    atomic_store_explicit(&span(fs, spanOffset(fs, data))->state, SPAN_RELEASED, memory_order_release);
+}
+
+void frame_store_get_stats(const frame_store_t *fs, frame_store_stats_t *stats) {
+    stats->capacity = fs->capacity;
+    stats->used = fs->used;
+    stats->usedPeak = fs->usedPeak;
+    stats->queued = frame_store_count(fs);
+    stats->queuedPeak = fs->countPeak;
+    stats->commits = fs->commits;
+    stats->failures = fs->failures;
+}
+
+void frame_store_clear_stats(frame_store_t *fs) {
+    fs->usedPeak = fs->used;
+    fs->countPeak = frame_store_count(fs);
+    fs->commits = 0;
+    fs->failures = 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef FRAME_STORE_H_
+#define FRAME_STORE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_queue.h"
+
+#define FRAME_STORE_ALIGN    (sizeof(void *)) // span alignment, spans may hold structures with pointers
+#define FRAME_STORE_MAX_SIZE 0xFFF0           // largest usable buffer, spans are addressed with 16-bit offsets
+
+/**
+ * @brief Frame store: a contiguous ring (bip-buffer) of variable size spans
+ * @details Every frame is kept in one contiguous span preceded by a small in-band header, a span never wraps
+ * around the end of the buffer. When a span does not fit at the end, the store continues at the beginning and
+ * the space left at the end is skipped until the oldest spans are freed.
+ * A span is reserved, grown if needed, written in place and then committed (trimmed to its final size and
+ * queued for the reader) or rolled back. Several reservations may be open at once and committed in any order.
+ * Committed spans are taken in commit order and may be released in any order. Free space is reclaimed from both ends of the ring.
+ * The writer and the reader may run in different contexts (e.g. a DSP task and an application task) without locks: committed
+ * spans are handed over through a single-producer single-consumer queue, and a release is a single atomic store that the
+ * writer observes when it reclaims space.
+ * @attention Reservations, growths, commits and rollbacks must come from one context, takes and releases from one context
+ */
+typedef struct FrameStore_s {
+    uint8_t *buffer;    // span memory, FRAME_STORE_ALIGN aligned
+    uint16_t capacity;  // buffer size in bytes
+    uint16_t head;      // write index, the next span starts here
+    uint16_t tail;      // read index, the oldest span starts here
+    uint16_t end;       // end of the spans in the upper part of the buffer after the write index wrapped, capacity if not wrapped
+    uint16_t newest;    // newest span, no span if the store is empty
+    uint16_t used;      // bytes in reserved, committed and taken spans, headers included, released spans count until reclaimed
+    uint16_t usedPeak;  // high-water mark of used
+    uint16_t countPeak; // high-water mark of the number of committed spans not taken yet
+    uint32_t commits;   // number of committed spans
+    uint32_t failures;  // number of reservations, growths and commits that failed for lack of space
+    frame_spsc_t queue; // committed spans not taken yet, writer to reader
+} frame_store_t;
+
+typedef struct FrameStoreStats_s {
+    uint16_t capacity;   // buffer size in bytes
+    uint16_t used;       // bytes in use now, span headers included, as last seen by the writer
+    uint16_t usedPeak;   // most bytes in use at once
+    uint16_t queued;     // committed spans not taken yet
+    uint16_t queuedPeak; // most committed spans waiting at once
+    uint32_t commits;    // number of committed spans
+    uint32_t failures;   // number of reservations and growths that failed, each one is a dropped frame
+} frame_store_stats_t;
+
+/**
+ * @brief Initialize frame store
+ * @param *fs Frame store
+ * @param *buffer Memory for spans, any alignment
+ * @param size Memory size in bytes, FRAME_STORE_MAX_SIZE at most is used
+ */
+void frame_store_init(frame_store_t *fs, void *buffer, size_t size);
+
+/**
+ * @brief Drop all spans
+ * @param *fs Frame store
+ * @attention Neither the writer nor the reader may use the store meanwhile
+ */
+void frame_store_clear(frame_store_t *fs);
+
+/**
+ * @brief Reserve a contiguous span
+ * @param *fs Frame store
+ * @param size Largest data size that will be written
+ * @return Span data, FRAME_STORE_ALIGN aligned, or NULL if there is no contiguous free space of this size
+ */
+void *frame_store_reserve(frame_store_t *fs, uint16_t size);
+
+/**
+ * @brief Enlarge a reserved span
+ * @details The span grows in place when it is the newest one and the space after it is free,
+ * otherwise a new span is reserved and the data written so far is copied.
+ * @param *fs Frame store
+ * @param *data Span data returned by frame_store_reserve() or frame_store_grow()
+ * @param size New largest data size
+ * @param keep Number of data bytes to keep
+ * @return Span data or NULL if there is no contiguous free space of this size, the span is left as it was then
+ */
+void *frame_store_grow(frame_store_t *fs, void *data, uint16_t size, uint16_t keep);
+
+/**
+ * @brief Commit a reserved span: trim it to its final size and queue it for the reader
+ * @param *fs Frame store
+ * @param *data Span data returned by frame_store_reserve()
+ * @param size Data size, not more than reserved
+ * @return False if FRAME_QUEUE_LEN spans are queued already, the span is rolled back then
+ */
+bool frame_store_commit(frame_store_t *fs, void *data, uint16_t size);
+
+/**
+ * @brief Drop a reserved span
+ * @param *fs Frame store
+ * @param *data Span data returned by frame_store_reserve()
+ */
+void frame_store_rollback(frame_store_t *fs, void *data);
+
+/**
+ * @brief Take the oldest committed span
+ * @param *fs Frame store
+ * @param *size Data size, may be NULL
+ * @return Span data or NULL if no span is committed. The span stays valid until frame_store_release() is called
+ */
+void *frame_store_take(frame_store_t *fs, uint16_t *size);
+
+/**
+ * @brief Release a taken span
+ * @details The space is reclaimed by the next reservation in the writer context.
+ * @param *fs Frame store
+ * @param *data Span data returned by frame_store_take()
+ */
+void frame_store_release(frame_store_t *fs, void *data);
+
+/**
+ * @brief Get number of committed spans not taken yet
+ * @param *fs Frame store
+ * @return Number of spans
+ */
+static inline uint16_t frame_store_count(const frame_store_t *fs) {
+    return (uint16_t)frame_spsc_count(&fs->queue);
+}
+
+/**
+ * @brief Get usage statistics, to size the store for a deployment
+ * @param *fs Frame store
+ * @param *stats Statistics
+ */
+void frame_store_get_stats(const frame_store_t *fs, frame_store_stats_t *stats);
+
+/**
+ * @brief Clear usage statistics, high-water marks restart from the current usage
+ * @param *fs Frame store
+ */
+void frame_store_clear_stats(frame_store_t *fs);
+
+#endif /* FRAME_STORE_H_ */
@@ -30,11 +30,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "APRSlib_tables.h"
 #include "fx25.h"
 #include "rs.h"
 
-#define FX25_RS_FCR 1
-#define FX25_PREGENERATE_POLYS
 #define FX25_MAX_DISTANCE 10 // maximum Hamming distance when comparing tags
 
 const fx25_mode_t fx25_mode_list[11] = {
@@ -77,65 +76,30 @@ const fx25_mode_t *fx25_get_mode_for_size(uint16_t size) {
         return NULL; // frame too big, do not use FX.25
 }
 
-#ifdef FX25_PREGENERATE_POLYS
-static lwfecrs_t rs16, rs32, rs64;
-#else
-static struct LwFecRS rs;
-#endif
-
-void fx25_encode(uint8_t *buffer, const fx25_mode_t *mode) {
-#ifdef FX25_PREGENERATE_POLYS
-    lwfecrs_t *rs = NULL;
+/**
+ * @brief Get Reed-Solomon generator for FX.25 mode
+ * @param *mode FX.25 mode
+ * @return Constant Reed-Solomon coder/decoder, see APRSlib_tables.h
+ */
+static const lwfecrs_t *getRs(const fx25_mode_t *mode) {
     switch (mode->parity_check_size) {
-        case 16:
-            rs = &rs16;
-            break;
         case 32:
-            rs = &rs32;
-            break;
+            return &fx25_rs32;
         case 64:
-            rs = &rs64;
-            break;
+            return &fx25_rs64;
         default:
-            rs = &rs16;
-            break;
+            return &fx25_rs16;
     }
-    RsEncode(rs, buffer, mode->data_size);
-#else
-    RsInit(&rs, mode->T, FX25_RS_FCR);
-    RsEncode(&rs, buffer, mode->K);
-#endif
+}
+
+void fx25_encode(uint8_t *buffer, const fx25_mode_t *mode) {
+    RsEncode(getRs(mode), buffer, mode->data_size);
 }
 
 bool fx25_decode(uint8_t *buffer, const fx25_mode_t *mode, uint8_t *fixed) {
-#ifdef FX25_PREGENERATE_POLYS
-    lwfecrs_t *rs = NULL;
-    switch (mode->parity_check_size) {
-        case 16:
-            rs = &rs16;
-            break;
-        case 32:
-            rs = &rs32;
-            break;
-        case 64:
-            rs = &rs64;
-            break;
-        default:
-            rs = &rs16;
-            break;
-    }
-    return RsDecode(rs, buffer, mode->data_size, fixed);
-#else
-    RsInit(&rs, mode->T, FX25_RS_FCR);
-    return RsDecode(&rs, buffer, mode->K, fixed);
-#endif
+    return RsDecode(getRs(mode), buffer, mode->data_size, fixed);
 }
 
 void fx25_init(void) {
-#ifdef FX25_PREGENERATE_POLYS
-    RsInit(&rs16, 16, FX25_RS_FCR);
-    RsInit(&rs32, 32, FX25_RS_FCR);
-    RsInit(&rs64, 64, FX25_RS_FCR);
-#else
-#endif
+    // nothing to calculate, Reed-Solomon generator polynomials are constant tables
 }
@@ -83,7 +83,7 @@ uint8_t GfPolyEval(uint8_t *p, uint8_t o, uint8_t x) {
     return ret;
 }
 
-uint8_t *GfPolyDiv(uint8_t *p1, uint8_t o1, uint8_t *p2, uint8_t o2, uint8_t *out) {
+uint8_t *GfPolyDiv(uint8_t *p1, uint8_t o1, const uint8_t *p2, uint8_t o2, uint8_t *out) {
     memcpy(out, p1, o1);
     for (uint8_t i = 0; i < (o1 - o2 + 1); i++) {
         uint8_t coeff = out[i];
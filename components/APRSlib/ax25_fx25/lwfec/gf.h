@@ -153,7 +153,7 @@ uint8_t GfPolyEval(uint8_t *p, uint8_t o, uint8_t x);
  * @warning This function works on polynomials orderder highest-degree-term-first
  * @return Pointer to the first element of the remainder
  */
-uint8_t *GfPolyDiv(uint8_t *p1, uint8_t o1, uint8_t *p2, uint8_t o2, uint8_t *out);
+uint8_t *GfPolyDiv(uint8_t *p1, uint8_t o1, const uint8_t *p2, uint8_t o2, uint8_t *out);
 
 /**
  * @brief Reverse the order of elements in a polynomial (in-place)
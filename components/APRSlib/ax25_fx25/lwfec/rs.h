@@ -46,7 +46,7 @@ typedef struct LwFecRS_s {
  * @param *fixed Output number of bytes corrected
  * @return True on success, false on failure
  */
-bool RsDecode(lwfecrs_t *rs, uint8_t *data, uint8_t size, uint8_t *fixed);
+bool RsDecode(const lwfecrs_t *rs, uint8_t *data, uint8_t size, uint8_t *fixed);
 
 /**
  * @brief Encode message using Reed-Solomon FEC
@@ -54,7 +54,7 @@ bool RsDecode(lwfecrs_t *rs, uint8_t *data, uint8_t size, uint8_t *fixed);
  * @param *data Input/output buffer. Must be of size N = 255
  * @param size Data size = K
  */
-void RsEncode(lwfecrs_t *rs, uint8_t *data, uint8_t size);
+void RsEncode(const lwfecrs_t *rs, uint8_t *data, uint8_t size);
 
 /**
  * @brief Initialize Reed-Solomon coder/decoder
@@ -35,24 +35,17 @@
 #include "ax25.h"
 #include "fx25.h"
 #include "modem.h"
+#include "rx_frontend.h"
 #include "APRSlib_port.h"
 
 static const char *TAG = "afsk";
 
 #define DEBUG_TNC
-#define FILTER_TAPS 8 // Number of taps in the FIR filter
 
 // Resampling configuration
 #define INPUT_RATE  38400
 #define OUTPUT_RATE 9600
 
-// AGC configuration
-#define AGC_TARGET_RMS 0.2f   // Target RMS level (-10dBFS)
-#define AGC_ATTACK     0.02f  // Fast attack rate
-#define AGC_RELEASE    0.001f // Slow release rate
-#define AGC_MAX_GAIN   10.0f
-#define AGC_MIN_GAIN   0.1f
-
 #define AX25_FLAG         0x7e
 #define AX25_MASK         0xfc // bit mask of MSb six bits
 #define AX25_EOP          0xfc // end of packet, 7e << 1
@@ -78,7 +71,6 @@ extern ax25ctx_t AX25;
 extern int mVrms;
 extern float dBV;
 
-int adcVal;
 int8_t _sql_pin, _ptt_pin, _pwr_pin, _dac_pin, _adc_pin;
 bool _sql_active, _ptt_active, _pwr_active;
 uint8_t adc_atten;
@@ -86,13 +78,12 @@ bool hw_afsk_dac_isr = false;
 uint16_t SAMPLERATE = 38400;
 uint16_t RESAMPLE_RATIO = (38400 / OUTPUT_RATE); // 38400/9600 = 3
 uint16_t BLOCK_SIZE = (38400 / 50);              // Must be multiple of resample ratio
-float *audio_buffer = NULL;
+int16_t *sample_buffer = NULL;
 int8_t _led_rx_pin = 2;
 int8_t _led_tx_pin = 4;
 int8_t _led_strip_pin = -1;
 uint8_t r_old = 0, g_old = 0, b_old = 0;
 unsigned long rgbTimeout = 0;
-float agc_gain = 1.0f;
 tcb_t tcb;
 volatile bool new_samples = false;
 uint8_t modem_config = 0;
@@ -109,40 +100,8 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
 long mVsum = 0;
 int mVsumCount = 0;
 uint8_t dcd_cnt = 0;
-
-// Filter coefficients (designed for 38400→9600 resampling)
-// cutoff = 4800  # Nyquist for 9600Hz
-static const float resample_coeffs[FILTER_TAPS] = { 0.003560, 0.038084, 0.161032, 0.297324, 0.297324, 0.161032, 0.038084, 0.003560 };
-
-static void resample_audio(float *input_buffer) {
-    // Apply anti-aliasing filter and decimate
-    for (int i = 0; i < BLOCK_SIZE / RESAMPLE_RATIO; i++) {
-        float sum = 0;
-        for (int j = 0; j < FILTER_TAPS; j++) {
-            int index = i * RESAMPLE_RATIO + j;
-            if (index < BLOCK_SIZE) {
-                sum += input_buffer[index] * resample_coeffs[j];
-            }
-        }
-        input_buffer[i] = sum;
-    }
-}
-
-static float update_agc(float *input_buffer, size_t len) {
-    // Calculate RMS of current block
-    float sum_sq = 0;
-    for (int i = 0; i < len; i++) {
-        sum_sq += input_buffer[i] * input_buffer[i];
-    }
-    float rms = sqrtf(sum_sq / len);
-
-    // Adjust gain based on RMS level
-    float error = AGC_TARGET_RMS / (rms + 1e-6f);
-    float rate = (error < 1.0f) ? AGC_RELEASE : AGC_ATTACK;
-    agc_gain = agc_gain * (1.0f - rate) + (agc_gain * error) * rate;
-    agc_gain = fmaxf(fminf(agc_gain, AGC_MAX_GAIN), AGC_MIN_GAIN);
-    return agc_gain;
-}
+static rx_frontend_t frontend;       // DC removal, AGC and conversion to the demodulator sample rate
+static uint16_t inputSampleRate = 0; // native ADC/sound card sample rate, 0 to use the modem default
 
 static void hw_init(void) {
     // Set up ADC
@@ -234,42 +193,88 @@ void afsk_set_ptt(bool state) {
     }
 }
 
+void afsk_set_input_samplerate(uint16_t rate) {
+    if ((rate > 0) && (rate < 9600)) {
+        log_i(TAG, "Input sample rate %d below demodulator rate", rate);
+        return;
+    }
+    inputSampleRate = rate;
+}
+
 void afsk_set_modem(uint8_t val, bool bpf, uint16_t timeSlot, uint16_t preamble, uint8_t fx25Mode) {
     if (bpf)
         ModemConfig.flatAudioIn = 1;
     else
         ModemConfig.flatAudioIn = 0;
 
+#if MODEM_FIXED_BAUDRATE == 1200
+    if ((val != 1) && (val != 2))
+        val = 1; // only the 1200 Bd decoder is built
+#elif MODEM_FIXED_BAUDRATE == 300
+    val = 0;
+#elif MODEM_FIXED_BAUDRATE == 9600
+    val = 3;
+#endif
+
+    // work out the new configuration first, the running one is only replaced when everything succeeds
+    modem_type_t modem = ModemConfig.modem;
+    uint16_t sampleRate = SAMPLERATE;
+    uint16_t blockSize = BLOCK_SIZE;
+    uint16_t resampleRatio = RESAMPLE_RATIO;
+
     if (val == 0) {
-        ModemConfig.modem = MODEM_300;
-        SAMPLERATE = 28800;
-        BLOCK_SIZE = (SAMPLERATE / 50); // Must be multiple of resample ratio
-        RESAMPLE_RATIO = (SAMPLERATE / 9600);
+        modem = MODEM_300;
+        sampleRate = 28800;
+        blockSize = (sampleRate / 50); // Must be multiple of resample ratio
+        resampleRatio = (sampleRate / 9600);
     } else if (val == 1) {
-        ModemConfig.modem = MODEM_1200;
-        SAMPLERATE = 19200;
-        BLOCK_SIZE = (SAMPLERATE / 50); // Must be multiple of resample ratio
-        RESAMPLE_RATIO = (SAMPLERATE / 9600);
+        modem = MODEM_1200;
+        sampleRate = 19200;
+        blockSize = (sampleRate / 50); // Must be multiple of resample ratio
+        resampleRatio = (sampleRate / 9600);
     } else if (val == 2) {
-        ModemConfig.modem = MODEM_1200_V23;
-        SAMPLERATE = 19200;
-        BLOCK_SIZE = (SAMPLERATE / 50); // Must be multiple of resample ratio
-        RESAMPLE_RATIO = (SAMPLERATE / 9600);
+        modem = MODEM_1200_V23;
+        sampleRate = 19200;
+        blockSize = (sampleRate / 50); // Must be multiple of resample ratio
+        resampleRatio = (sampleRate / 9600);
     } else if (val == 3) {
-        ModemConfig.modem = MODEM_9600;
-        SAMPLERATE = 38400;
-        BLOCK_SIZE = (SAMPLERATE / 100); // Must be multiple of resample ratio
-        RESAMPLE_RATIO = (SAMPLERATE / 38400);
+        modem = MODEM_9600;
+        sampleRate = 38400;
+        blockSize = (sampleRate / 100); // Must be multiple of resample ratio
+        resampleRatio = (sampleRate / 38400);
     }
-    if (audio_buffer != NULL) {
-        free(audio_buffer);
-        audio_buffer = NULL;
+
+    // stop polling, the old buffer and front end do not match the new configuration
+    if (sample_buffer != NULL) {
+        free(sample_buffer);
+        sample_buffer = NULL;
+    }
+
+    uint16_t demodRate = sampleRate / resampleRatio;
+    if (inputSampleRate > 0) { // native input rate, converted by the front end
+        if (inputSampleRate < demodRate) {
+            log_i(TAG, "Input sample rate %d below demodulator rate %d, modem not started", inputSampleRate, demodRate);
+            return;
+        }
+        blockSize = (uint32_t)blockSize * inputSampleRate / sampleRate; // keep the block duration
+        sampleRate = inputSampleRate;
+        resampleRatio = sampleRate / demodRate;
     }
-    audio_buffer = (float *)calloc(BLOCK_SIZE, sizeof(float));
-    if (audio_buffer == NULL) {
-        log_i(TAG, "Error allocating memory for audio buffer");
+    if (!rx_frontend_init(&frontend, sampleRate, demodRate)) {
+        log_i(TAG, "Unsupported sample rate conversion %d -> %d, modem not started", sampleRate, demodRate);
         return;
     }
+    int16_t *buffer = (int16_t *)calloc(blockSize, sizeof(int16_t));
+    if (buffer == NULL) {
+        log_i(TAG, "Error allocating memory for sample buffer");
+        return;
+    }
+
+    ModemConfig.modem = modem;
+    SAMPLERATE = sampleRate;
+    BLOCK_SIZE = blockSize;
+    RESAMPLE_RATIO = resampleRatio;
+    sample_buffer = buffer;
     log_i(TAG, "Modem: %d, SampleRate: %d, BlockSize: %d", ModemConfig.modem, SAMPLERATE, BLOCK_SIZE);
     ModemConfig.usePWM = 1;
     modem_init();
@@ -341,7 +346,7 @@ void afsk_poll(void) {
 
     if (hw_afsk_dac_isr) {
     } else {
-        if (audio_buffer != NULL) {
+        if (sample_buffer != NULL) {
             tcb_t *tp = &tcb;
             while (port_queue_getcount() >= BLOCK_SIZE) {
                 mVsum = 0;
@@ -357,7 +362,6 @@ void afsk_poll(void) {
                     tp->avg = tp->avg_sum / TCB_AVG_N;
 
                     // carrier detect
-                    adcVal = (int)adc - tp->avg;
                     int m = 1;
                     if ((RESAMPLE_RATIO > 1) || (ModemConfig.modem == MODEM_9600)) {
                         m = 4;
@@ -370,11 +374,10 @@ void afsk_poll(void) {
                         mVsumCount++;
                     }
 
-                    float sample = adcVal / 2048.0f * agc_gain;
-                    audio_buffer[x] = sample;
+                    sample_buffer[x] = adc;
                 }
-                // Update AGC gain
-                update_agc(audio_buffer, BLOCK_SIZE);
+                // DC removal, AGC and sample rate conversion, in place
+                size_t n = rx_frontend_process(&frontend, sample_buffer, x, sample_buffer);
                 port_adc_cali_raw_to_voltage(tp->avg, &offset);
 
                 if (mVsumCount > 0) {
@@ -394,18 +397,8 @@ void afsk_poll(void) {
 
                 if ((dcd_cnt > 3) || (ModemConfig.modem == MODEM_9600)) {
                     tp->cdt = true;
-                    //  Process audio block
-                    if (RESAMPLE_RATIO > 1)
-                        resample_audio(audio_buffer);
-
                     // Process audio block
-                    int16_t sample;
-
-                    for (int i = 0; i < BLOCK_SIZE / RESAMPLE_RATIO; i++) {
-                        // Convert back to 12-bit audio (0-4095)
-                        sample = audio_buffer[i] * 2048;
-                        modem_decode(sample, mVrms);
-                    }
+                    modem_decode_block(sample_buffer, n, mVrms);
                 } else {
                     tp->cdt = false;
                 }
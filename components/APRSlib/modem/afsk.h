@@ -33,8 +33,9 @@
 #include <stdint.h>
 
 #include "APRSlib_port.h"
+#include "APRSlib_tables.h"
 
-#define SIN_LEN                      512
+#define SIN_LEN                      DAC_SINE_LEN // sin_table period, see APRSlib_tables.h
 #define SWITCH_TONE(inc)             (((inc) == MARK_INC) ? SPACE_INC : MARK_INC)
 #define BITS_DIFFER(bits1, bits2)    (((bits1) ^ (bits2)) & 0x01)
 #define DUAL_XOR(bits1, bits2)       ((((bits1) ^ (bits2)) & 0x03) == 0x03)
@@ -137,14 +138,6 @@ typedef struct TCB_s { // TNC Control Block
 
 extern int offset;
 
-static const uint8_t sin_table[] = {
-    128, 129, 131, 132, 134, 135, 137, 138, 140, 142, 143, 145, 146, 148, 149, 151, 152, 154, 155, 157, 158, 160, 162, 163, 165, 166,
-    167, 169, 170, 172, 173, 175, 176, 178, 179, 181, 182, 183, 185, 186, 188, 189, 190, 192, 193, 194, 196, 197, 198, 200, 201, 202,
-    203, 205, 206, 207, 208, 210, 211, 212, 213, 214, 215, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231,
-    232, 233, 234, 234, 235, 236, 237, 238, 238, 239, 240, 241, 241, 242, 243, 243, 244, 245, 245, 246, 246, 247, 248, 248, 249, 249,
-    250, 250, 250, 251, 251, 252, 252, 252, 253, 253, 253, 253, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255,
-};
-
 inline static uint8_t sinSample(uint16_t i) {
     uint16_t newI = i % (SIN_LEN / 2);
     newI = (newI >= (SIN_LEN / 4)) ? (SIN_LEN / 2 - newI - 1) : newI;
@@ -159,6 +152,7 @@ void afsk_set_ptt_value(int8_t val, bool act);
 bool afsk_get_transmit(void);
 void afsk_set_transmit(bool val);
 bool afsk_get_receive(void);
+void afsk_set_input_samplerate(uint16_t rate);
 void afsk_set_modem(uint8_t val, bool bpf, uint16_t timeSlot, uint16_t preamble, uint8_t fx25Mode);
 void afsk_set_ptt(bool state);
 
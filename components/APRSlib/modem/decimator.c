@@ -0,0 +1,198 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "decimator.h"
+#include "fir_engine.h"
+
+#if (DECIMATOR_MAX_TAPS % FIR_ENGINE_TAPS_ALIGN) != 0
+#error "DECIMATOR_MAX_TAPS must be a multiple of FIR_ENGINE_TAPS_ALIGN"
+#endif
+
+// Anti-aliasing filters, Hamming windowed sinc, gain 32768
+// passband ripple < 0.5 dB up to 2200 Hz, stopband from 7200 Hz (aliases into 0-2400 Hz after decimation)
+
+// fs=19200 Hz, fc=3700 Hz, N=16, stopband -71 dB
+static const int16_t aaf2[16] = {
+    37,    //
+    192,   //
+    161,   //
+    -682,  //
+    -1555, //
+    366,   //
+    6139,  //
+    11726, //
+    11726, //
+    6139,  //
+    366,   //
+    -1555, //
+    -682,  //
+    161,   //
+    192,   //
+    37     //
+};
+
+// fs=28800 Hz, fc=3700 Hz, N=24, stopband -62 dB
+static const int16_t aaf3[24] = {
+    10,    //
+    78,    //
+    158,   //
+    151,   //
+    -104,  //
+    -615,  //
+    -1042, //
+    -757,  //
+    745,   //
+    3367,  //
+    6248,  //
+    8145,  //
+    8145,  //
+    6248,  //
+    3367,  //
+    745,   //
+    -757,  //
+    -1042, //
+    -615,  //
+    -104,  //
+    151,   //
+    158,   //
+    78,    //
+    10     //
+};
+
+// fs=38400 Hz, fc=3600 Hz, N=32, stopband -65 dB
+static const int16_t aaf4[32] = {
+    16,   //
+    50,   //
+    90,   //
+    119,  //
+    95,   //
+    -29,  //
+    -264, //
+    -551, //
+    -748, //
+    -666, //
+    -138, //
+    896,  //
+    2332, //
+    3904, //
+    5251, //
+    6027, //
+    6027, //
+    5251, //
+    3904, //
+    2332, //
+    896,  //
+    -138, //
+    -666, //
+    -748, //
+    -551, //
+    -264, //
+    -29,  //
+    95,   //
+    119,  //
+    90,   //
+    50,   //
+    16    //
+};
+
+bool decimator_init(decimator_t *d, uint8_t ratio) {
+    const int16_t *coeffs = NULL;
+    uint8_t taps = 0;
+
+    memset(d, 0, sizeof(*d));
+
+    switch (ratio) {
+        case 1:
+            break;
+        case 2:
+            coeffs = aaf2;
+            taps = sizeof(aaf2) / sizeof(*aaf2);
+            break;
+        case 3:
+            coeffs = aaf3;
+            taps = sizeof(aaf3) / sizeof(*aaf3);
+            break;
+        case 4:
+            coeffs = aaf4;
+            taps = sizeof(aaf4) / sizeof(*aaf4);
+            break;
+        default:
+            return false;
+    }
+
+    d->ratio = ratio;
+    d->taps = taps;
+    for (uint8_t i = 0; i < taps; i++) // store reversed, so that coeffs[0] multiplies the oldest sample
+        d->coeffs[i] = coeffs[taps - 1 - i];
+
+    // start with zeroed history, first output after ratio input samples
+    if (taps > 0) {
+        d->fill = taps - 1;
+        d->next = taps - 1 + ratio - 1;
+    }
+    return true;
+}
+
+size_t decimator_process(decimator_t *d, const int16_t *in, size_t n, int16_t *out) {
+    size_t k = 0;
+
+    if (d->ratio == 1) {
+        if (out != in)
+            memmove(out, in, n * sizeof(*in));
+        return n;
+    }
+
+    while (n > 0) {
+        size_t chunk = (sizeof(d->buffer) / sizeof(*d->buffer)) - d->fill;
+        if (chunk > n)
+            chunk = n;
+
+        memcpy(&d->buffer[d->fill], in, chunk * sizeof(*in)); // input is consumed before any output is written, so in-place use is safe
+        d->fill += chunk;
+        in += chunk;
+        n -= chunk;
+
+        while (d->next < d->fill) {
+            out[k++] = fir_dotprod_s16(d->coeffs, &d->buffer[d->next + 1 - d->taps], d->taps) >> 15;
+            d->next += d->ratio;
+        }
+
+        // move the samples still needed to the beginning of the buffer
+        uint16_t start = d->next + 1 - d->taps;
+        memmove(d->buffer, &d->buffer[start], (d->fill - start) * sizeof(*d->buffer));
+        d->fill -= start;
+        d->next -= start;
+    }
+
+    return k;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DECIMATOR_MAX_TAPS 32  // longest anti-aliasing filter
+#define DECIMATOR_CHUNK    128 // input samples copied to the work buffer at once
+
+/**
+ * @brief Streaming decimator to the 9600 Hz demodulator sample rate
+ * @details Input samples are appended to a linear work buffer after the history of the previous block, so every output sample is a single
+ * contiguous dot product. Only every ratio-th output is calculated, which is the polyphase form of the filter with all phases summed.
+ * History is kept between blocks, so there is no discontinuity at block boundaries.
+ */
+typedef struct Decimator_s {
+    int16_t coeffs[DECIMATOR_MAX_TAPS];                   // anti-aliasing filter coefficients, oldest sample first
+    int16_t buffer[DECIMATOR_MAX_TAPS + DECIMATOR_CHUNK]; // sample history followed by new samples, oldest first
+    uint16_t fill;                                        // number of samples in buffer
+    uint16_t next;                                        // buffer index of the newest sample used by the next output
+    uint8_t taps;                                         // filter length, a multiple of 8
+    uint8_t ratio;                                        // decimation ratio
+} decimator_t;
+
+/**
+ * @brief Initialize decimator
+ * @param *d Decimator state
+ * @param ratio Decimation ratio: 1 (no decimation), 2, 3 or 4
+ * @return True on success, false if ratio is not supported
+ */
+bool decimator_init(decimator_t *d, uint8_t ratio);
+
+/**
+ * @brief Decimate a block of samples
+ * @param *d Decimator state
+ * @param *in Input samples
+ * @param n Number of input samples
+ * @param *out Output samples, can be the same buffer as in
+ * @return Number of output samples
+ */
+size_t decimator_process(decimator_t *d, const int16_t *in, size_t n, int16_t *out);
+
+#endif /* DECIMATOR_H_ */
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(FIR_ENGINE_FORCE_SCALAR)
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__XTENSA__)
+#include <xtensa/config/core.h>
+#endif
+#endif
+
+#include "fir_engine.h"
+
+// x86 hosts built without AVX2: choose the AVX2 or SSE2 kernel at load time, on the CPU the program runs on
+#if !defined(FIR_ENGINE_FORCE_SCALAR) && defined(__SSE2__) && !defined(__AVX2__) && defined(__GNUC__) && defined(__ELF__) && defined(__x86_64__)
+#define FIR_ENGINE_DISPATCH
+#endif
+
+// ESP32 MAC16 unit: 40-bit multiply-accumulate with parallel loads of 32-bit aligned operand pairs
+#if !defined(FIR_ENGINE_FORCE_SCALAR) && defined(__XTENSA__) && XCHAL_HAVE_MAC16
+#define FIR_ENGINE_MAC16
+#endif
+
+#if defined(FIR_ENGINE_FORCE_SCALAR) || !(defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON) || defined(FIR_ENGINE_MAC16))
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    int32_t sum = 0;
+
+    for (uint16_t i = 0; i < n; i++)
+        sum += (int32_t)a[i] * b[i];
+
+    return sum;
+}
+#elif defined(__AVX2__) || defined(__SSE2__)
+/**
+ * @brief SSE2 dot product of the vector tails
+ * @param *a First vector
+ * @param *b Second vector
+ * @param i Start index, a multiple of 8
+ * @param n Vector length, a multiple of 8
+ * @param acc Sums of the vector heads, 4 lanes
+ * @return Dot product
+ */
+static inline __attribute__((always_inline)) int32_t dotprodSse2(const int16_t *a, const int16_t *b, uint16_t i, uint16_t n, __m128i acc) {
+    for (; i < n; i += 8) {
+        __m128i va = _mm_loadu_si128((const __m128i *)&a[i]);
+        __m128i vb = _mm_loadu_si128((const __m128i *)&b[i]);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(va, vb)); // 8x int16 * int16, pairwise summed to 4x int32
+    }
+
+    // horizontal sum of 4 lanes
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+#if defined(__AVX2__) || defined(FIR_ENGINE_DISPATCH)
+/**
+ * @brief AVX2 dot product, 16 elements per step
+ * @param *a First vector
+ * @param *b Second vector
+ * @param n Vector length, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+ * @return Dot product
+ */
+__attribute__((target("avx2"))) static int32_t dotprodAvx2(const int16_t *a, const int16_t *b, uint16_t n) {
+    __m256i acc256 = _mm256_setzero_si256();
+    uint16_t i = 0;
+
+    for (; (i + 16) <= n; i += 16) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)&a[i]);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)&b[i]);
+        acc256 = _mm256_add_epi32(acc256, _mm256_madd_epi16(va, vb)); // 16x int16 * int16, pairwise summed to 8x int32
+    }
+    return dotprodSse2(a, b, i, n, _mm_add_epi32(_mm256_castsi256_si128(acc256), _mm256_extracti128_si256(acc256, 1)));
+}
+#endif
+
+#if defined(__AVX2__)
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    return dotprodAvx2(a, b, n);
+}
+#else
+/**
+ * @brief SSE2 dot product
+ * @param *a First vector
+ * @param *b Second vector
+ * @param n Vector length, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+ * @return Dot product
+ */
+static int32_t dotprodSse2Only(const int16_t *a, const int16_t *b, uint16_t n) {
+    return dotprodSse2(a, b, 0, n, _mm_setzero_si128());
+}
+
+#ifdef FIR_ENGINE_DISPATCH
+typedef int32_t (*dotprod_fn_t)(const int16_t *a, const int16_t *b, uint16_t n);
+
+/**
+ * @brief Select the dot product kernel, called by the dynamic loader before any constructor
+ * @return Kernel for the CPU the program runs on
+ */
+static dotprod_fn_t resolveDotprod(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? dotprodAvx2 : dotprodSse2Only;
+}
+
+static int32_t dotprodLong(const int16_t *a, const int16_t *b, uint16_t n) __attribute__((ifunc("resolveDotprod")));
+
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    if (n < 16) // AVX2 has nothing to add to a single SSE2 step, skip the indirect call
+        return dotprodSse2(a, b, 0, n, _mm_setzero_si128());
+    return dotprodLong(a, b, n);
+}
+#else
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    return dotprodSse2Only(a, b, n);
+}
+#endif
+#endif
+#elif defined(__ARM_NEON)
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    int32x4_t acc = vdupq_n_s32(0);
+
+    for (uint16_t i = 0; i < n; i += 8) {
+        int16x8_t va = vld1q_s16(&a[i]);
+        int16x8_t vb = vld1q_s16(&b[i]);
+        acc = vmlal_s16(acc, vget_low_s16(va), vget_low_s16(vb)); // 4x int16 * int16 accumulated to 4x int32
+        acc = vmlal_s16(acc, vget_high_s16(va), vget_high_s16(vb));
+    }
+
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+#elif defined(FIR_ENGINE_MAC16)
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n) {
+    if ((n == 0) || ((((uintptr_t)a | (uintptr_t)b) & 3) != 0)) // MAC16 loads need both vectors 32-bit aligned
+    {
+        int32_t sum = 0;
+
+        for (uint16_t i = 0; i < n; i++)
+            sum += (int32_t)a[i] * b[i];
+        return sum;
+    }
+
+    int32_t sum = 0;
+    int32_t sumh = 0;
+    const uint32_t *p = (const uint32_t *)a + 1; // +1 for lddec
+    const uint32_t *q = (const uint32_t *)b + 1;
+
+    // the loop loads the operands of the next 4 elements while multiplying, the last 4 are multiplied after the loop,
+    // so that nothing is read past the vector ends
+    asm volatile("wsr.acclo	%[sum]\n\t"  // acc_lo = 0;
+                 "wsr.acchi	%[sumh]\n\t" // acc_hi = 0;
+
+                 "lddec	m0, %[p]\n\t" // m0 = a[0..1];
+                 "lddec	m2, %[q]\n\t" // m2 = b[0..1];
+                 "ldinc	m1, %[p]\n\t" // m1 = a[2..3];
+
+                 "loopgtz	%[count], %=f\n\t" // loop n / 4 - 1 times
+
+                 "mula.dd.ll.ldinc m3, %[q], m0, m2\n\t" // acc += (int16_t)m0 * (int16_t)m2; m3 = *++q;
+                 "mula.dd.hh.ldinc m0, %[p], m0, m2\n\t" // acc += (m0 >> 16) * (m2 >> 16);   m0 = *++p;
+                 "mula.dd.ll.ldinc m2, %[q], m1, m3\n\t" // acc += (int16_t)m1 * (int16_t)m3; m2 = *++q;
+                 "mula.dd.hh.ldinc m1, %[p], m1, m3\n\t" // acc += (m1 >> 16) * (m3 >> 16);   m1 = *++p;
+
+                 "%=:\n\t"
+
+                 "ldinc	m3, %[q]\n\t"       // m3 = b[n - 2 .. n - 1];
+                 "mula.dd.ll	m0, m2\n\t" // acc += (int16_t)m0 * (int16_t)m2;
+                 "mula.dd.hh	m0, m2\n\t" // acc += (m0 >> 16) * (m2 >> 16);
+                 "mula.dd.ll	m1, m3\n\t" // acc += (int16_t)m1 * (int16_t)m3;
+                 "mula.dd.hh	m1, m3\n\t" // acc += (m1 >> 16) * (m3 >> 16);
+
+                 "rsr.acclo	%[sum]\n\t" // sum = acc_lo;
+
+                 : [sum] "+r"(sum), [sumh] "+r"(sumh), [p] "+r"(p), [q] "+r"(q)
+                 : [count] "r"(n / 4 - 1)
+                 : "memory");
+    return sum;
+}
+#endif
+
+#if defined(FIR_ENGINE_FORCE_SCALAR) || !(defined(__SSE2__) || defined(__ARM_NEON))
+void fir_dotprod_lanes_s16(const int16_t *coeffs, const int16_t *history, uint16_t stride, uint8_t taps, uint8_t lanes, int32_t *out) {
+    for (uint8_t i = 0; i < lanes; i++) {
+        int32_t sum = 0;
+
+        for (uint8_t k = 0; k < taps; k++)
+            sum += (int32_t)coeffs[k] * history[k * stride + i];
+        out[i] = sum;
+    }
+}
+#elif defined(__SSE2__)
+void fir_dotprod_lanes_s16(const int16_t *coeffs, const int16_t *history, uint16_t stride, uint8_t taps, uint8_t lanes, int32_t *out) {
+    for (uint8_t i = 0; i < lanes; i += 4) {
+        const int16_t *h = &history[i];
+        __m128i acc = _mm_setzero_si128();
+        uint8_t k = 0;
+
+        for (; (k + 2) <= taps; k += 2, h += 2 * stride) { // two taps per step: interleave them and let madd sum the pairs
+            __m128i c = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)coeffs[k + 1] << 16) | (uint16_t)coeffs[k]));
+            __m128i x = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)h), _mm_loadl_epi64((const __m128i *)(h + stride)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(x, c));
+        }
+        if (k < taps) { // odd tap count
+            __m128i c = _mm_set1_epi32((uint16_t)coeffs[k]);
+            __m128i x = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)h), _mm_setzero_si128());
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(x, c));
+        }
+        _mm_storeu_si128((__m128i *)&out[i], acc);
+    }
+}
+#elif defined(__ARM_NEON)
+void fir_dotprod_lanes_s16(const int16_t *coeffs, const int16_t *history, uint16_t stride, uint8_t taps, uint8_t lanes, int32_t *out) {
+    for (uint8_t i = 0; i < lanes; i += 4) {
+        int32x4_t acc = vdupq_n_s32(0);
+
+        for (uint8_t k = 0; k < taps; k++)
+            acc = vmlal_n_s16(acc, vld1_s16(&history[k * stride + i]), coeffs[k]); // 4x int16 * int16 accumulated to 4x int32
+        vst1q_s32(&out[i], acc);
+    }
+}
+#endif
+
+void fir_engine_init(fir_engine_t *fir, const int16_t *coeffs, uint8_t taps, uint8_t gainShift) {
+    if (taps > FIR_ENGINE_MAX_TAPS)
+        taps = FIR_ENGINE_MAX_TAPS;
+
+    memset(fir->coeffs, 0, sizeof(fir->coeffs));
+    memcpy(fir->coeffs, coeffs, taps * sizeof(*coeffs));
+
+    fir->taps = (taps + FIR_ENGINE_TAPS_ALIGN - 1) & ~(FIR_ENGINE_TAPS_ALIGN - 1); // padding taps have zero coefficients
+    fir->gainShift = gainShift;
+    fir_engine_reset(fir);
+}
+
+void fir_engine_reset(fir_engine_t *fir) {
+    memset(fir->history, 0, sizeof(fir->history));
+    fir->pos = 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef FIR_ENGINE_H_
+#define FIR_ENGINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// uncomment to use esp-dsp dsps_dotprod_s16() on ESP32 targets
+// esp-dsp rounds the result and returns it as 16 bits, so the output is not bit-identical with the other kernels
+// #define FIR_ENGINE_USE_ESP_DSP
+
+// uncomment to force the scalar kernel on hosts with SIMD extensions (bit-identical reference)
+// #define FIR_ENGINE_FORCE_SCALAR
+
+#ifdef FIR_ENGINE_USE_ESP_DSP
+#include <dsps_dotprod.h>
+#endif
+
+#define FIR_ENGINE_MAX_TAPS   16 // maximum number of taps, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+#define FIR_ENGINE_TAPS_ALIGN 8  // taps are zero-padded to a multiple of this value, so the vector kernels need no scalar tail
+
+// number of interleaved filters processed at once by fir_dotprod_lanes_s16()
+#if !defined(FIR_ENGINE_FORCE_SCALAR) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define FIR_ENGINE_LANE_GROUP 4
+#else
+#define FIR_ENGINE_LANE_GROUP 1
+#endif
+
+/**
+ * @brief FIR filter with a doubled history buffer
+ * @details Each input sample is stored twice, taps apart, so the last taps samples are always
+ * available as a contiguous vector starting at history[pos] (newest sample first). No samples are moved.
+ */
+typedef struct FirEngine_s {
+    int16_t coeffs[FIR_ENGINE_MAX_TAPS];      // coefficients, zero-padded to taps
+    int16_t history[2 * FIR_ENGINE_MAX_TAPS]; // doubled sample history
+    uint8_t taps;                             // number of taps after padding
+    uint8_t pos;                              // history index of the newest sample
+    uint8_t gainShift;                        // output right shift
+} fir_engine_t;
+
+/**
+ * @brief Calculate dot product of two int16 vectors with int32 accumulation
+ * @param *a First vector
+ * @param *b Second vector
+ * @param n Vector length, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+ * @return Dot product
+ */
+int32_t fir_dotprod_s16(const int16_t *a, const int16_t *b, uint16_t n);
+
+/**
+ * @brief Calculate dot product of two int16 vectors, shifted right
+ * @details Uses esp-dsp when FIR_ENGINE_USE_ESP_DSP is defined, fir_dotprod_s16() otherwise.
+ * esp-dsp shifts the result right by 15 - shift, larger shifts are applied afterwards.
+ * @param *a First vector
+ * @param *b Second vector
+ * @param n Vector length, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+ * @param shift Right shift of the result
+ * @return Shifted dot product
+ */
+static inline int32_t fir_dotprod_shift_s16(const int16_t *a, const int16_t *b, uint16_t n, uint8_t shift) {
+#ifdef FIR_ENGINE_USE_ESP_DSP
+    int16_t out;
+    dsps_dotprod_s16(a, b, &out, n, (shift > 15) ? 0 : (15 - shift));
+    return (shift > 15) ? (out >> (shift - 15)) : out;
+#else
+    return fir_dotprod_s16(a, b, n) >> shift;
+#endif
+}
+
+/**
+ * @brief Calculate outputs of several filters with the same coefficients and interleaved sample histories
+ * @details Sample k of filter (lane) i is stored at history[k * stride + i], so each tap is applied to a group of lanes at once.
+ * @param *coeffs Coefficients, coeffs[0] multiplies history[0 .. lanes - 1]
+ * @param *history Interleaved sample histories
+ * @param stride Distance between consecutive samples of one lane
+ * @param taps Number of taps
+ * @param lanes Number of lanes, must be a multiple of FIR_ENGINE_LANE_GROUP
+ * @param *out Dot products, one per lane
+ */
+void fir_dotprod_lanes_s16(const int16_t *coeffs, const int16_t *history, uint16_t stride, uint8_t taps, uint8_t lanes, int32_t *out);
+
+/**
+ * @brief Initialize FIR filter
+ * @param *fir Filter state
+ * @param *coeffs Filter coefficients
+ * @param taps Number of coefficients, up to FIR_ENGINE_MAX_TAPS
+ * @param gainShift Output right shift
+ */
+void fir_engine_init(fir_engine_t *fir, const int16_t *coeffs, uint8_t taps, uint8_t gainShift);
+
+/**
+ * @brief Clear filter history
+ * @param *fir Filter state
+ */
+void fir_engine_reset(fir_engine_t *fir);
+
+/**
+ * @brief Filter one sample
+ * @param *fir Filter state
+ * @param input Input sample
+ * @return Output sample
+ */
+static inline int32_t fir_engine_process(fir_engine_t *fir, int16_t input) {
+    if (fir->pos == 0)
+        fir->pos = fir->taps;
+    fir->pos--;
+
+    fir->history[fir->pos] = input; // store new sample in both halves
+    fir->history[fir->pos + fir->taps] = input;
+
+    return fir_dotprod_shift_s16(fir->coeffs, &fir->history[fir->pos], fir->taps, fir->gainShift);
+}
+
+#endif /* FIR_ENGINE_H_ */
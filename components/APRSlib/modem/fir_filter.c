@@ -6,17 +6,27 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef __XTENSA__
 #include <xtensa/config/core.h>
 #endif
 
 #include "APRSlib_port.h"
+#include "fir_engine.h"
 #include "fir_filter.h"
 
+// ESP32 MAC16 kernel with its own coefficient layout, the other targets use the fir_engine.h kernels
+// (esp-dsp, SSE2/AVX2, NEON or scalar) on a doubled sample history
+#if defined(__XTENSA__) && XCHAL_HAVE_MAC16 && !defined(FIR_ENGINE_USE_ESP_DSP) && !defined(FIR_ENGINE_FORCE_SCALAR)
+#define FIR_FILTER_MAC16
+#endif
+
 static const char *TAG = "fir_filter";
 
+#ifdef FIR_FILTER_MAC16
 int fir_filter(filter_t *fp, int16_t value) {
     int32_t sum = 0;
 
@@ -24,7 +34,6 @@ int fir_filter(filter_t *fp, int16_t value) {
     //
     fp->x[fp->index] = value;
 
-#ifdef __XTENSA__
     uint32_t *p;
     // start index of "x"
     uint32_t *q = (uint32_t *)fp->x + 1; // +1 for lddec
@@ -61,18 +70,38 @@ int fir_filter(filter_t *fp, int16_t value) {
         log_i(TAG, "sumh = %d", (int)sumh);
     }
 
-#else  // __XTENSA__
-    for (int i = 0; i < fp->size; i++) {
-        sum += fp->an[i] * fp->x[(fp->index + i) % fp->size];
-    }
-#endif // __XTENSA__
-
     fp->index += fp->size - 1;
     fp->index %= fp->size;
 
     return sum >> 16;
 }
 
+void fir_filter_block(filter_t *fp, const int16_t *in, int32_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i] = fir_filter(fp, in[i]);
+}
+#else  // FIR_FILTER_MAC16
+static inline int32_t filterSample(filter_t *fp, int16_t value) {
+    if (fp->index == 0)
+        fp->index = fp->taps;
+    fp->index--;
+
+    fp->x[fp->index] = value; // store new sample in both halves, the last taps samples start at x[index]
+    fp->x[fp->index + fp->taps] = value;
+
+    return fir_dotprod_shift_s16(fp->an, &fp->x[fp->index], fp->taps, 16);
+}
+
+int fir_filter(filter_t *fp, int16_t value) {
+    return filterSample(fp, value);
+}
+
+void fir_filter_block(filter_t *fp, const int16_t *in, int32_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i] = filterSample(fp, in[i]);
+}
+#endif // FIR_FILTER_MAC16
+
 // sinc function
 static float sinc(float x) {
     if (fabsf(x) < 1e-6)
@@ -99,7 +128,7 @@ int16_t *fir_filter_coeff(filter_param_t const *f) {
     const int A = (1 << 15) - 1; // amplitude
     int16_t *an;
 
-#ifdef __XTENSA__
+#ifdef FIR_FILTER_MAC16
     an = (int16_t *)calloc(size * 3 + 1, sizeof(int16_t));
 #else
     an = (int16_t *)calloc(size + 1, sizeof(int16_t));
@@ -115,7 +144,7 @@ int16_t *fir_filter_coeff(filter_param_t const *f) {
         an[n + M] = A * 2 * (Rc * sinc(2 * M_PI * Rc * n) - Rp * sinc(2 * M_PI * Rp * n)) * windowf(M_PI * n / M);
     }
 
-#ifdef __XTENSA__
+#ifdef FIR_FILTER_MAC16
     // prepare coeffient an_i for "mula" instruction
     // mula use 3 copy of an_i
     for (int i = 0; i < size; i++) {
@@ -129,10 +158,23 @@ int16_t *fir_filter_coeff(filter_param_t const *f) {
 void fir_filter_init(filter_t *fp, int16_t an[], int size) {
     int16_t *p;
 
-    fp->an = an;
     fp->size = size;
+    fp->index = 0;
 
+#ifdef FIR_FILTER_MAC16
+    fp->an = an;
     p = (int16_t *)calloc((size + 3) & ~3, sizeof(int16_t));
+#else
+    // zero-padded copy of the coefficients and a doubled history for the vector kernels
+    fp->taps = (size + FIR_ENGINE_TAPS_ALIGN - 1) & ~(FIR_ENGINE_TAPS_ALIGN - 1);
+    fp->an = (int16_t *)calloc(fp->taps, sizeof(int16_t));
+    if (fp->an == NULL) {
+        log_i(TAG, "calloc");
+        exit(1);
+    }
+    memcpy(fp->an, an, size * sizeof(int16_t));
+    p = (int16_t *)calloc(2 * fp->taps, sizeof(int16_t));
+#endif
     if (p == NULL) {
         log_i(TAG, "calloc");
         exit(1);
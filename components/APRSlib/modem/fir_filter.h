@@ -2,6 +2,7 @@
 #define FIR_FILTER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define FIR_BPF_N (8 * 4 - 1)
@@ -12,6 +13,7 @@ typedef struct FIR_FILTER {
     int16_t *x;
     int size;
     int index;
+    int taps; // size padded to FIR_ENGINE_TAPS_ALIGN, not used by the MAC16 kernel
 } filter_t;
 
 typedef struct FILTER_PARAM {
@@ -22,6 +24,7 @@ typedef struct FILTER_PARAM {
 } filter_param_t;
 
 int fir_filter(filter_t *fp, int16_t value);
+void fir_filter_block(filter_t *fp, const int16_t *in, int32_t *out, size_t n);
 void fir_filter_init(filter_t *fp, int16_t an[], int size);
 int16_t *fir_filter_coeff(filter_param_t const *f);
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "APRSlib_tables.h"
+#include "g3ruh.h"
+
+// bytes are sent LSB first, the LFSR keeps the newest bit in bit 0, so bytes are bit-reversed on the way in and out
+
+uint8_t g3ruh_scramble_byte(uint32_t *lfsr, uint8_t in) {
+    return bit_reverse_table[g3ruh_scramble_word(lfsr, bit_reverse_table[in], 8)];
+}
+
+uint8_t g3ruh_descramble_byte(uint32_t *lfsr, uint8_t in) {
+    return bit_reverse_table[g3ruh_descramble_word(lfsr, bit_reverse_table[in], 8)];
+}
+
+void g3ruh_scramble(uint32_t *lfsr, const uint8_t *in, uint8_t *out, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        out[i] = g3ruh_scramble_byte(lfsr, in[i]);
+}
+
+void g3ruh_descramble(uint32_t *lfsr, const uint8_t *in, uint8_t *out, size_t len) {
+    uint32_t state = *lfsr;
+    size_t i = 0;
+
+    for (; (i + 4) <= len; i += 4) { // no feedback, 32 bits at once
+        uint32_t word = ((uint32_t)bit_reverse_table[in[i]] << 24) | ((uint32_t)bit_reverse_table[in[i + 1]] << 16) |
+                        ((uint32_t)bit_reverse_table[in[i + 2]] << 8) | bit_reverse_table[in[i + 3]];
+
+        word = g3ruh_descramble_word(&state, word, 32);
+        out[i] = bit_reverse_table[word >> 24];
+        out[i + 1] = bit_reverse_table[(word >> 16) & 0xFF];
+        out[i + 2] = bit_reverse_table[(word >> 8) & 0xFF];
+        out[i + 3] = bit_reverse_table[word & 0xFF];
+    }
+    for (; i < len; i++)
+        out[i] = g3ruh_descramble_byte(&state, in[i]);
+
+    *lfsr = state;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef G3RUH_H_
+#define G3RUH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// G3RUH scrambler for 9600 Bd baseband, polynomial x^17+x^12+1
+// The scrambler feeds its output back, the descrambler is self-synchronizing and only uses the received bits.
+// The LFSR holds the last bits, newest in bit 0, so an output bit depends on bits 16 and 11 of the LFSR.
+// Several bits are processed at once with shifts: every output bit only depends on bits at least 12 positions older,
+// so the scrambler handles up to 12 bits per step, the descrambler (no feedback) up to 32.
+
+#define G3RUH_LFSR_INIT      0xFFFFF // initial LFSR state
+#define G3RUH_SCRAMBLE_WIDTH 12      // bits the scrambler can process in one step
+
+/**
+ * @brief Scramble one bit
+ * @param[in,out] *lfsr Scrambler LFSR
+ * @param in Input bit
+ * @return Scrambled bit
+ */
+static inline uint8_t g3ruh_scramble_bit(uint32_t *lfsr, uint8_t in) {
+    uint8_t bit = ((*lfsr >> 16) ^ (*lfsr >> 11) ^ (in > 0)) & 1;
+
+    *lfsr = (*lfsr << 1) | bit;
+    return bit;
+}
+
+/**
+ * @brief Descramble one bit
+ * @param[in,out] *lfsr Descrambler LFSR
+ * @param in Received bit
+ * @return Descrambled bit
+ */
+static inline uint8_t g3ruh_descramble_bit(uint32_t *lfsr, uint8_t in) {
+    uint8_t bit = ((*lfsr >> 16) ^ (*lfsr >> 11) ^ in) & 1;
+
+    *lfsr = (*lfsr << 1) | (in & 1);
+    return bit;
+}
+
+/**
+ * @brief Scramble up to 32 bits
+ * @details Bits are ordered like in the LFSR: the oldest bit is bit count-1, the newest is bit 0.
+ * Gives the same result and LFSR state as count calls of g3ruh_scramble_bit().
+ * @param[in,out] *lfsr Scrambler LFSR
+ * @param in Input bits
+ * @param count Number of bits, 1 to 32
+ * @return Scrambled bits, same order
+ */
+static inline uint32_t g3ruh_scramble_word(uint32_t *lfsr, uint32_t in, uint8_t count) {
+    uint32_t out = 0;
+
+    while (count > 0) {
+        uint8_t k = (count > G3RUH_SCRAMBLE_WIDTH) ? G3RUH_SCRAMBLE_WIDTH : count;
+        uint32_t mask = (1UL << k) - 1;
+        uint32_t r = *lfsr << k; // feedback taps of the k new bits are all in the old LFSR bits
+        uint32_t bits = ((in >> (count - k)) ^ (r >> 12) ^ (r >> 17)) & mask;
+
+        *lfsr = r | bits;
+        out = (out << k) | bits;
+        count -= k;
+    }
+
+    return out;
+}
+
+/**
+ * @brief Descramble up to 32 bits
+ * @details Bits are ordered like in the LFSR: the oldest bit is bit count-1, the newest is bit 0.
+ * Gives the same result and LFSR state as count calls of g3ruh_descramble_bit().
+ * @param[in,out] *lfsr Descrambler LFSR
+ * @param in Received bits
+ * @param count Number of bits, 1 to 32
+ * @return Descrambled bits, same order
+ */
+static inline uint32_t g3ruh_descramble_word(uint32_t *lfsr, uint32_t in, uint8_t count) {
+    uint64_t mask = ((uint64_t)1 << count) - 1;
+    uint64_t r = ((uint64_t)*lfsr << count) | (in & mask);
+
+    *lfsr = (uint32_t)r;
+    return (uint32_t)((r ^ (r >> 12) ^ (r >> 17)) & mask);
+}
+
+/**
+ * @brief Scramble one byte in transmission order
+ * @details Bit 0 is sent first, like AX.25 bytes.
+ * @param[in,out] *lfsr Scrambler LFSR
+ * @param in Input byte
+ * @return Scrambled byte
+ */
+uint8_t g3ruh_scramble_byte(uint32_t *lfsr, uint8_t in);
+
+/**
+ * @brief Descramble one byte in transmission order
+ * @details Bit 0 was received first.
+ * @param[in,out] *lfsr Descrambler LFSR
+ * @param in Received byte
+ * @return Descrambled byte
+ */
+uint8_t g3ruh_descramble_byte(uint32_t *lfsr, uint8_t in);
+
+/**
+ * @brief Scramble a block of bytes in transmission order
+ * @param[in,out] *lfsr Scrambler LFSR
+ * @param[in] *in Input bytes
+ * @param[out] *out Scrambled bytes, can be the same buffer as in
+ * @param len Number of bytes
+ */
+void g3ruh_scramble(uint32_t *lfsr, const uint8_t *in, uint8_t *out, size_t len);
+
+/**
+ * @brief Descramble a block of bytes in transmission order
+ * @param[in,out] *lfsr Descrambler LFSR
+ * @param[in] *in Received bytes
+ * @param[out] *out Descrambled bytes, can be the same buffer as in
+ * @param len Number of bytes
+ */
+void g3ruh_descramble(uint32_t *lfsr, const uint8_t *in, uint8_t *out, size_t len);
+
+#endif /* G3RUH_H_ */
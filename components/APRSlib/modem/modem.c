@@ -33,8 +33,11 @@
 #include <string.h>
 
 #include "APRSlib_port.h"
+#include "APRSlib_tables.h"
 #include "afsk.h"
 #include "ax25.h"
+#include "fir_engine.h"
+#include "g3ruh.h"
 #include "modem.h"
 
 static const char *TAG = "modem";
@@ -81,6 +84,29 @@ static const char *TAG = "modem";
 #define N300  32 // fs=9600, oversampling = 38400 Hz
 #define NMAX  32 // keep this value equal to the biggest Nx
 
+#ifdef MODEM_FIXED_BAUDRATE
+#if MODEM_FIXED_BAUDRATE == 1200
+#define FIXED_N     N1200
+#define FIXED_MODEM MODEM_1200
+#elif MODEM_FIXED_BAUDRATE == 300
+#define FIXED_N     N300
+#define FIXED_MODEM MODEM_300
+#else
+#define FIXED_N     N9600
+#define FIXED_MODEM MODEM_9600
+#endif
+#else
+#define FIXED_MODEM MODEM_1200 // fallback for unknown modem types
+#endif
+
+#if NMAX > TONE_MAX_N
+#error "TONE_MAX_N is too small for the correlators"
+#endif
+
+// Pre-selector of an offset bank: tone energy measurement length in symbols
+// 4 symbols give 75 Hz resolution at 300 Bd, enough to tell 50 Hz offset steps apart together with averaging
+#define MODEM_SURVEY_SYMBOLS 4
+
 #define PLL1200_STEP (((uint64_t)1 << 32) / N1200) // PLL tick increment value
 #define PLL9600_STEP (((uint64_t)1 << 32) / N9600)
 #define PLL300_STEP  (((uint64_t)1 << 32) / N300)
@@ -107,61 +133,123 @@ static const char *TAG = "modem";
 #define BPF_MAX_TAPS    15
 #define FILTER_MAX_TAPS ((LPF_MAX_TAPS > BPF_MAX_TAPS) ? LPF_MAX_TAPS : BPF_MAX_TAPS)
 
-typedef struct Filter_s {
-    int16_t *coeffs;
-    uint8_t taps;
-    int32_t samples[FILTER_MAX_TAPS];
-    uint8_t gainShift;
-} filter_t;
-
-typedef struct DemodState_s {
-    uint8_t rawSymbols;  // raw, unsynchronized symbols
-    uint8_t syncSymbols; // synchronized symbols
-
-    modem_prefilter_t prefilter;
-    filter_t bpf;
-    int16_t correlatorSamples[NMAX];
-    uint8_t correlatorSamplesIdx;
-    filter_t lpf;
-
-    uint8_t dcd : 1; // DCD state
-
-    int32_t pll; // bit recovery PLL counter
-    uint64_t pllStep;
-    int32_t pllLockedTune;
-    int32_t pllNotLockedTune;
-
-    int32_t dcdPll;        // DCD PLL main counter
-    uint8_t dcdLastSymbol; // last symbol for DCD
-    uint16_t dcdCounter;   // DCD "pulse" counter (incremented when RX signal is correct)
-    uint16_t dcdMax;
-    uint16_t dcdThres;
-    uint16_t dcdInc;
-    uint16_t dcdDec;
-    int32_t dcdTune;
-
-    int16_t peak;
-    int16_t valley;
-} demod_state_t;
+#if FILTER_MAX_TAPS > FIR_ENGINE_MAX_TAPS
+#error "FIR_ENGINE_MAX_TAPS is too small for modem filters"
+#endif
+
+// Tone detector low-pass filters are processed in groups of SIMD lanes, unused lanes in the last group are processed as well
+#define DEMOD_LANE_GROUP FIR_ENGINE_LANE_GROUP // 1 without SIMD, so that only used lanes are processed
+#define DEMOD_LANES      (((MODEM_MAX_DEMODULATOR_COUNT) + DEMOD_LANE_GROUP - 1) / DEMOD_LANE_GROUP * DEMOD_LANE_GROUP)
+
+typedef struct InputStage_s {
+    modem_prefilter_t prefilter; // input filter type
+    fir_engine_t bpf;            // input filter, not used for PREFILTER_NONE
+    int16_t out;                 // filtered current sample
+    int16_t old;                 // sample that has just left the correlator window
+    int16_t window[2 * NMAX];    // correlator window of the last N samples, stored twice like fir_engine_t history
+    uint8_t windowIdx;           // index of the oldest sample, window[windowIdx] .. window[windowIdx + N - 1] is contiguous
+} input_stage_t;
+
+typedef struct Detector_s {
+    uint8_t input; // input stage index
+    modem_demod_type_t type;
+    const tone_set_t *tones; // correlator coefficients, shared between detectors using the same tones
+    int32_t sdftLoI, sdftLoQ, sdftHiI, sdftHiQ; // sliding DFT accumulators
+    uint8_t sdftIdx;                            // oscillator table index of the newest sample
+    uint8_t sdftOldIdx;                         // oscillator table index of the sample leaving the window
+    int32_t delayProducts[NMAX];                // delay line discriminator products in the averaging window
+    int32_t delaySum;                           // sum of delayProducts
+    uint8_t delay;                              // discriminator delay in samples, less than N
+    uint8_t delayShift;                         // log2(N), turns delaySum into a mean
+    bool delayInvert;                           // discriminator output is negative for the mark tone
+    bool active;                                // runs on every sample, stopped by the pre-selector otherwise
+    int32_t surveyMark[2];                      // Goertzel filter state at the mark tone, for the pre-selector
+    int32_t surveySpace[2];                     // Goertzel filter state at the space tone
+    int64_t level;                              // tone energy averaged over surveys
+} detector_t;
+
+/**
+ * @brief Demodulator bank in structure-of-arrays layout
+ * @details Tone detector outputs and their low-pass filters use one lane per tone detector, bit recovery and DCD use one lane per
+ * demodulator. All values of one kind are stored together, so each processing step is a single loop over all lanes. The symbol
+ * low-pass filters of all tone detectors are computed at once by fir_dotprod_lanes_s16() on interleaved histories.
+ */
+typedef struct DemodBank_s {
+    // tone detector lanes
+    int16_t lpfCoeffs[FILTER_MAX_TAPS];                        // symbol low-pass filter coefficients, shared by all tone detectors
+    int16_t lpfHistory[2 * FILTER_MAX_TAPS][2 * DEMOD_LANES];  // interleaved, doubled sample histories (see fir_engine_t)
+    uint8_t lpfTaps;                                           // symbol low-pass filter length
+    uint8_t lpfPos;                                            // history index of the newest sample
+    uint8_t lpfGainShift;                                      // symbol low-pass filter output right shift
+    uint8_t detectorLanes;                                     // tone detector lanes to process, a multiple of DEMOD_LANE_GROUP
+    uint8_t filterLanes;                                       // low-pass filter lanes, twice detectorLanes when tone energy is needed
+    int32_t detectorOut[2 * DEMOD_LANES];                      // tone detector output for the current sample, then tone energy
+    int32_t detectorFiltered[2 * DEMOD_LANES];                 // low-pass filtered detectorOut for the current sample
+
+    // demodulator lanes
+    uint8_t demodLanes;                    // demodulator lanes to process
+    uint8_t detector[DEMOD_LANES];         // tone detector index
+    int32_t in[DEMOD_LANES];               // tone detector output gathered for this demodulator
+    int32_t symbol[DEMOD_LANES];           // low-pass filtered symbol gathered for this demodulator
+    int32_t slicerLevel[DEMOD_LANES];      // data slicer threshold relative to the tone energy, Q15
+    uint32_t rawSymbols[DEMOD_LANES];      // raw, unsynchronized symbols
+    uint32_t syncSymbols[DEMOD_LANES];     // synchronized symbols, not descrambled yet
+    int32_t pll[DEMOD_LANES];              // bit recovery PLL counter
+    int32_t pllLockedTune[DEMOD_LANES];    // PLL tuning when DCD is on, PLL_TUNE_BITS fractional bits
+    int32_t pllNotLockedTune[DEMOD_LANES]; // PLL tuning when DCD is off, PLL_TUNE_BITS fractional bits
+    int32_t dcd[DEMOD_LANES];              // DCD state
+    int32_t dcdPll[DEMOD_LANES];           // DCD PLL main counter
+    int32_t dcdLastSymbol[DEMOD_LANES];    // last symbol for DCD
+    int32_t dcdCounter[DEMOD_LANES];       // DCD "pulse" counter (incremented when RX signal is correct)
+    int32_t dcdMax[DEMOD_LANES];
+    int32_t dcdThres[DEMOD_LANES];
+    int32_t dcdInc[DEMOD_LANES];
+    int32_t dcdDec[DEMOD_LANES];
+    int32_t dcdTune[DEMOD_LANES];
+    uint32_t lfsr[DEMOD_LANES];            // descrambler LFSR for 9600 Bd
+    uint32_t lastSymbol[DEMOD_LANES];      // last descrambled symbol of the previous byte, for NRZI decoding
+    int32_t bitCount[DEMOD_LANES];         // synchronized symbols not passed to the higher level protocol yet
+} demod_bank_t;
+
+struct ModemCtx_s {
+    modem_demod_config_t config;                             // modem configuration
+    uint8_t N;                                               // samples per symbol
+    float markFreq;                                          // mark frequency
+    float spaceFreq;                                         // space frequency
+    float baudRate;                                          // baudrate
+    const tone_set_t *toneSets[MODEM_MAX_DEMODULATOR_COUNT]; // correlator coefficients for each distinct mark/space pair
+    tone_set_t toneStore[MODEM_MAX_DEMODULATOR_COUNT];       // tone sets calculated at run time, for tones without a constant table
+    uint8_t toneSetCount;                                    // number of tone sets in use
+    input_stage_t inputs[MODEM_MAX_DEMODULATOR_COUNT];       // input filters, one for each distinct prefilter
+    uint8_t inputCount;                                      // number of input stages in use
+    detector_t detectors[MODEM_MAX_DEMODULATOR_COUNT];       // tone detectors, one for each distinct input stage, tones and detector type
+    uint8_t detectorCount;                                   // number of tone detectors in use
+    uint8_t selectCount;                                     // number of correlators kept active by the pre-selector, 0 to run all
+    uint16_t surveyCounter;                                  // samples since the last pre-selector survey
+    int16_t peak;                                            // input signal positive peak
+    int16_t valley;                                          // input signal negative peak
+    uint32_t pllStep;                                        // bit recovery PLL tick increment, 2^32 / N
+    demod_bank_t bank;                                       // parallel demodulators
+    uint8_t demodCount;                                      // actual number of parallel demodulators
+    uint8_t dcd;                                             // multiplexed DCD state from all demodulators
+    bool statusLed;                                          // DCD is shown on the status LED
+    ax25_rx_t *rx;                                           // HDLC decoder and received frame buffer
+};
 
 extern int8_t adcEn;
 extern int8_t dacEn;
 extern bool hw_afsk_dac_isr;
 
-static uint8_t N;                                                              // samples per symbol
 static modem_tx_test_mode_t txTestState;                                          // current TX test mode
-static uint8_t demodCount;                                                     // actual number of parallel demodulators
 static uint8_t currentSymbol;                                                  // current symbol for NRZI encoding
 static uint8_t scrambledSymbol;                                                // current symbol after scrambling
 static uint16_t markStep;                                                      // mark timer step
 static uint16_t spaceStep;                                                     // space timer step
 static uint16_t baudRateStep;                                                  // baudrate timer step
-static int16_t coeffHiI[NMAX], coeffLoI[NMAX], coeffHiQ[NMAX], coeffLoQ[NMAX]; // correlator IQ coefficients
-static uint8_t dcd = 0;                                                        // multiplexed DCD state from both demodulators
-static uint32_t lfsr = 0xFFFFF;                                                // LFSR for 9600 Bd
+static uint32_t txLfsr = G3RUH_LFSR_INIT;                                      // scrambler LFSR for 9600 Bd
 static uint16_t phaseAcc = 0;
 static uint16_t sampleIndex = 0;
-static demod_state_t demodState[MODEM_MAX_DEMODULATOR_COUNT];
+static modem_ctx_t defaultCtx; // context used by the legacy single channel API and by TX
 
 modem_demod_config_t ModemConfig;
 float markFreq;  // mark frequency
@@ -267,21 +355,29 @@ static const int16_t lpf9600[9] = {
     497    //
 };
 
-static void decode(uint8_t symbol, uint8_t demod, uint16_t mV);
-static int32_t demodulate(int16_t sample, demod_state_t *dem);
-
-static int32_t filter(filter_t *filter, int32_t input) {
-    int32_t out = 0;
-
-    for (uint8_t i = filter->taps - 1; i > 0; i--)
-        filter->samples[i] = filter->samples[i - 1]; // shift old samples
-
-    filter->samples[0] = input; // store new sample
-    for (uint8_t i = 0; i < filter->taps; i++) {
-        out += (int32_t)filter->coeffs[i] * filter->samples[i];
+static inline uint8_t symbolSamples(const modem_ctx_t *ctx);
+static inline uint32_t symbolStep(const modem_ctx_t *ctx);
+static inline bool isBaseband(const modem_ctx_t *ctx);
+static modem_type_t builtModem(modem_type_t modem);
+static inline void trackAmplitude(modem_ctx_t *ctx, int16_t sample);
+static inline int16_t detect(const modem_ctx_t *ctx, detector_t *det, const input_stage_t *in, int16_t *energy);
+static inline void filterSymbols(demod_bank_t *b);
+static inline void updateDcd(modem_ctx_t *ctx);
+static inline void recoverBits(modem_ctx_t *ctx);
+static inline uint8_t recoveredByte(modem_ctx_t *ctx, uint8_t demod);
+static inline void surveyTones(modem_ctx_t *ctx);
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
     }
-    // dsps_dotprod_s16_ae32(filter->coeffs,(int16_t *)filter->samples,)
-    return out >> filter->gainShift;
+    return a;
+}
+
+modem_ctx_t *modem_get_default_ctx(void) {
+    return &defaultCtx;
 }
 
 float modem_get_baudrate(void) {
@@ -289,11 +385,23 @@ float modem_get_baudrate(void) {
 }
 
 uint8_t modem_get_demodulator_count(void) {
-    return demodCount;
+    return defaultCtx.demodCount;
+}
+
+uint8_t modem_ctx_get_demodulator_count(const modem_ctx_t *ctx) {
+    return ctx->demodCount;
 }
 
 uint8_t modem_dcd_state(void) {
-    return dcd;
+    return defaultCtx.dcd;
+}
+
+uint8_t modem_ctx_dcd_state(const modem_ctx_t *ctx) {
+    return ctx->dcd;
+}
+
+struct Ax25Rx_s *modem_ctx_get_rx(modem_ctx_t *ctx) {
+    return ctx->rx;
 }
 
 uint8_t modem_is_tx_test_ongoing(void) {
@@ -304,13 +412,23 @@ uint8_t modem_is_tx_test_ongoing(void) {
 }
 
 void modem_get_signal_level(uint8_t modem, int8_t *peak, int8_t *valley, uint8_t *level) {
-    *peak = (100 * (int32_t)demodState[modem].peak) >> 12;
-    *valley = (100 * (int32_t)demodState[modem].valley) >> 12;
-    *level = (100 * (int32_t)(demodState[modem].peak - demodState[modem].valley)) >> 13;
+    modem_ctx_get_signal_level(&defaultCtx, modem, peak, valley, level);
+}
+
+void modem_ctx_get_signal_level(const modem_ctx_t *ctx, uint8_t modem, int8_t *peak, int8_t *valley, uint8_t *level) {
+    (void)modem; // all demodulators see the same input signal
+
+    *peak = (100 * (int32_t)ctx->peak) >> 12;
+    *valley = (100 * (int32_t)ctx->valley) >> 12;
+    *level = (100 * (int32_t)(ctx->peak - ctx->valley)) >> 13;
 }
 
 modem_prefilter_t modem_get_filter_type(uint8_t modem) {
-    return demodState[modem].prefilter;
+    return modem_ctx_get_filter_type(&defaultCtx, modem);
+}
+
+modem_prefilter_t modem_ctx_get_filter_type(const modem_ctx_t *ctx, uint8_t modem) {
+    return ctx->inputs[ctx->detectors[ctx->bank.detector[modem]].input].prefilter;
 }
 
 /**
@@ -325,48 +443,91 @@ static void setDcd(bool state) {
     }
 }
 
-static inline uint8_t descramble(uint8_t in) {
-    // G3RUH descrambling (x^17+x^12+1)
-    uint8_t bit = ((lfsr & 0x10000) > 0) ^ ((lfsr & 0x800) > 0) ^ (in > 0);
+/**
+ * @brief ISR for demodulator
+ */
 
-    lfsr <<= 1;
-    lfsr |= in;
-    return bit;
+void modem_decode(int16_t sample, uint16_t mVrms) {
+    modem_ctx_decode_block(&defaultCtx, &sample, 1, mVrms);
 }
 
-static inline uint8_t scramble(uint8_t in) {
-    // G3RUH scrambling (x^17+x^12+1)
-    uint8_t bit = ((lfsr & 0x10000) > 0) ^ ((lfsr & 0x800) > 0) ^ (in > 0);
-
-    lfsr <<= 1;
-    lfsr |= bit;
-    return bit;
+void modem_decode_block(const int16_t *samples, size_t n, uint16_t mVrms) {
+    modem_ctx_decode_block(&defaultCtx, samples, n, mVrms);
 }
 
-/**
- * @brief ISR for demodulator
- */
+void modem_ctx_decode(modem_ctx_t *ctx, int16_t sample, uint16_t mVrms) {
+    modem_ctx_decode_block(ctx, &sample, 1, mVrms);
+}
 
-void modem_decode(int16_t sample, uint16_t mVrms) {
+void modem_ctx_decode_block(modem_ctx_t *ctx, const int16_t *samples, size_t n, uint16_t mVrms) {
     bool partialDcd = false;
+    const bool afsk = !isBaseband(ctx);
+    const uint8_t N = symbolSamples(ctx);
+    demod_bank_t *bank = &ctx->bank;
+
+    // stages shared by several demodulators are computed once per sample and their results fanned out
+    for (size_t s = 0; s < n; s++) {
+        int16_t sample = samples[s];
+
+        trackAmplitude(ctx, sample);
+
+        for (uint8_t i = 0; i < ctx->inputCount; i++) { // input filters, once for each distinct prefilter
+            input_stage_t *in = &ctx->inputs[i];
+            in->out = (in->prefilter != PREFILTER_NONE) ? fir_engine_process(&in->bpf, sample) : sample;
+            in->old = in->window[in->windowIdx]; // the correlator window is shared by all detectors of this input
+            in->window[in->windowIdx] = in->out;
+            in->window[in->windowIdx + N] = in->out;
+            if (++in->windowIdx == N)
+                in->windowIdx = 0;
+        }
 
-    for (uint8_t i = 0; i < demodCount; i++) {
-        uint8_t symbol = (demodulate(sample, (demod_state_t *)&demodState[i]) > 0); // demodulate sample
+        if (ctx->selectCount) // tone energies of all correlators, measured much cheaper than by running them
+            surveyTones(ctx);
 
-        decode(symbol, i, mVrms); // recover bits, decode NRZI and call higher level function
-        if (demodState[i].dcd)
-            partialDcd = true;
+        for (uint8_t i = 0; i < ctx->detectorCount; i++) { // tone detection, once for each distinct input, tones and detector type
+            detector_t *det = &ctx->detectors[i];
+            int16_t energy = abs(sample) >> 1;
+
+            if (!det->active) {
+                bank->detectorOut[i] = 0;
+                bank->detectorOut[bank->detectorLanes + i] = 0;
+                continue;
+            }
+
+            bank->detectorOut[i] = afsk ? detect(ctx, det, &ctx->inputs[det->input], &energy) : sample;
+            bank->detectorOut[bank->detectorLanes + i] = energy;
+        }
+
+        filterSymbols(bank);
+
+        for (uint8_t i = 0; i < bank->demodLanes; i++) { // fan tone detector outputs out to the demodulators and slice them
+            uint8_t d = bank->detector[i];
+            int32_t threshold = (bank->detectorFiltered[bank->detectorLanes + d] * bank->slicerLevel[i]) >> 14; // energy is halved
+            bank->in[i] = bank->detectorOut[d];
+            bank->symbol[i] = (bank->detectorFiltered[d] > threshold);
+        }
+
+        updateDcd(ctx);
+        recoverBits(ctx);
+
+        for (uint8_t i = 0; i < bank->demodLanes; i++) { // pass recovered bits to higher level function, a byte at a time
+            if (bank->bitCount[i] == 8) {
+                uint8_t bits = recoveredByte(ctx, i);
+                if (i < ctx->demodCount)
+                    ax25_rx_byte_parse(ctx->rx, bits, i, mVrms);
+            }
+        }
     }
 
-    if (partialDcd) // DCD on any of the demodulators
-    {
-        setDcd(true);
-        dcd = 1;
-    } else // no DCD on both demodulators
-    {
-        setDcd(false);
-        dcd = 0;
+    for (uint8_t i = 0; i < ctx->demodCount; i++) {
+        if (bank->dcd[i])
+            partialDcd = true;
     }
+
+    if (ctx->statusLed && (partialDcd != ctx->dcd)) // update LED only when the multiplexed DCD state changes
+        setDcd(partialDcd);
+
+    ctx->dcd = partialDcd; // DCD on any of the demodulators at the end of the block
 }
 
 /**
@@ -380,10 +541,12 @@ uint8_t modem_baudrate_timer_handler(void) {
             currentSymbol ^= 1; // change symbol - NRZI encoding
         }
         sampleIndex = baudRateStep;
+
+        if (isBaseband(&defaultCtx)) // TX runs on the default context settings, G3RUH scrambling once per symbol
+            scrambledSymbol = g3ruh_scramble_bit(&txLfsr, currentSymbol);
     }
 
-    if (ModemConfig.modem == MODEM_9600) {
-        scrambledSymbol = scramble(currentSymbol);
+    if (isBaseband(&defaultCtx)) {
         sinwave = scrambledSymbol ? 240 : 20;
     } else {
         if (currentSymbol) {
@@ -400,54 +563,209 @@ uint8_t modem_baudrate_timer_handler(void) {
 }
 
 /**
- * @brief Demodulate received sample (4x oversampling)
- * @param[in] sample Received sample, no more than 13 bits
- * @param[in] *dem Demodulator state
- * @return Current tone (0 or 1)
+ * @brief Delay line (delay-and-multiply) FM discriminator
+ * @details x(n) * x(n - d) of a tone f has a DC component proportional to cos(2 pi f d / fs) and a component at 2f.
+ * The delay is chosen so that the DC component has opposite signs for mark and space, the 2f component is removed by averaging
+ * over one symbol, which nulls all harmonics of the baudrate just like the correlator window.
+ * @param[in] *ctx Modem context
+ * @param[in] *det Tone detector state
+ * @param[in] *in Input stage, the newest sample already stored in the correlator window
+ * @return Positive for mark, negative for space
+ */
+static inline int16_t delayLine(const modem_ctx_t *ctx, detector_t *det, const input_stage_t *in) {
+    const int16_t *window = &in->window[in->windowIdx]; // oldest sample first
+    const int16_t *newest = &window[symbolSamples(ctx) - 1];
+    int32_t product = ((int32_t)newest[0] * newest[-det->delay]) >> 4; // keep the window sum within 32 bits
+
+    det->delaySum += product - det->delayProducts[in->windowIdx]; // replace the product of N samples ago
+    det->delayProducts[in->windowIdx] = product;
+
+    int32_t out = det->delaySum >> (det->delayShift + 4); // window mean, scaled by 2^-8
+    if (out > INT16_MAX)
+        out = INT16_MAX;
+    else if (out < -INT16_MAX)
+        out = -INT16_MAX;
+
+    return det->delayInvert ? -out : out;
+}
+
+/**
+ * @brief Get samples per symbol, a constant in MODEM_FIXED_BAUDRATE builds
+ * @param[in] *ctx Modem context
+ * @return Samples per symbol
+ */
+static inline uint8_t symbolSamples(const modem_ctx_t *ctx) {
+#ifdef MODEM_FIXED_BAUDRATE
+    (void)ctx;
+    return FIXED_N;
+#else
+    return ctx->N;
+#endif
+}
+
+/**
+ * @brief Get bit recovery PLL tick increment, a constant in MODEM_FIXED_BAUDRATE builds
+ * @param[in] *ctx Modem context
+ * @return 2^32 / samples per symbol
  */
-static int32_t demodulate(int16_t sample, demod_state_t *dem) {
-    // input signal amplitude tracking
-    if (sample >= dem->peak) {
-        dem->peak += (((int32_t)(AMP_TRACKING_ATTACK * (float)32768) * (int32_t)(sample - dem->peak)) >> 15);
+static inline uint32_t symbolStep(const modem_ctx_t *ctx) {
+#ifdef MODEM_FIXED_BAUDRATE
+    (void)ctx;
+    return (uint32_t)(((uint64_t)1 << 32) / FIXED_N);
+#else
+    return ctx->pllStep;
+#endif
+}
+
+/**
+ * @brief Check for the 9600 Bd baseband (G3RUH) modem, a constant in MODEM_FIXED_BAUDRATE builds
+ * @param[in] *ctx Modem context
+ * @return True for 9600 Bd, false for AFSK
+ */
+static inline bool isBaseband(const modem_ctx_t *ctx) {
+#ifdef MODEM_FIXED_BAUDRATE
+    (void)ctx;
+    return (FIXED_MODEM == MODEM_9600);
+#else
+    return (ctx->config.modem == MODEM_9600);
+#endif
+}
+
+/**
+ * @brief Track input signal amplitude
+ * @param[in] *ctx Modem context
+ * @param[in] sample Received sample
+ */
+static inline void trackAmplitude(modem_ctx_t *ctx, int16_t sample) {
+    if (sample >= ctx->peak) {
+        ctx->peak += (((int32_t)(AMP_TRACKING_ATTACK * (float)32768) * (int32_t)(sample - ctx->peak)) >> 15);
     } else {
-        dem->peak += (((int32_t)(AMP_TRACKING_DECAY * (float)32768) * (int32_t)(sample - dem->peak)) >> 15);
+        ctx->peak += (((int32_t)(AMP_TRACKING_DECAY * (float)32768) * (int32_t)(sample - ctx->peak)) >> 15);
     }
 
-    if (sample <= dem->valley) {
-        dem->valley -= (((int32_t)(AMP_TRACKING_ATTACK * (float)32768) * (int32_t)(dem->valley - sample)) >> 15);
+    if (sample <= ctx->valley) {
+        ctx->valley -= (((int32_t)(AMP_TRACKING_ATTACK * (float)32768) * (int32_t)(ctx->valley - sample)) >> 15);
     } else {
-        dem->valley -= (((int32_t)(AMP_TRACKING_DECAY * (float)32768) * (int32_t)(dem->valley - sample)) >> 15);
+        ctx->valley -= (((int32_t)(AMP_TRACKING_DECAY * (float)32768) * (int32_t)(ctx->valley - sample)) >> 15);
     }
+}
 
-    if (ModemConfig.modem != MODEM_9600) {
-        if (dem->prefilter != PREFILTER_NONE) // filter is used
-        {
-            dem->correlatorSamples[dem->correlatorSamplesIdx++] = filter(&dem->bpf, sample);
-        } else // no pre/deemphasis
-        {
-            dem->correlatorSamples[dem->correlatorSamplesIdx++] = sample;
-        }
-
-        dem->correlatorSamplesIdx %= N;
-
-        int32_t outLoI = 0, outLoQ = 0, outHiI = 0, outHiQ = 0; // output values after correlating
+/**
+ * @brief Detect AFSK tone in received sample (4x oversampling)
+ * @param[in] *ctx Modem context
+ * @param[in] *det Tone detector state
+ * @param[in] *in Input stage with the received sample after the input filter, no more than 13 bits, stored in the correlator window
+ * @param[out] *energy Half of the total tone energy, used by data slicers
+ * @return Positive for mark, negative for space
+ */
+static inline int16_t detect(const modem_ctx_t *ctx, detector_t *det, const input_stage_t *in, int16_t *energy) {
+    if (det->type == DEMOD_DELAY_LINE) {
+        *energy = 0; // the discriminator output does not depend on the tone amplitudes, so there is nothing to compensate
+        return delayLine(ctx, det, in);
+    }
 
-        for (uint8_t i = 0; i < N; i++) {
-            int16_t t = dem->correlatorSamples[(dem->correlatorSamplesIdx + i) % N]; // read sample
-            outLoI += t * coeffLoI[i];                                               // correlate sample
-            outLoQ += t * coeffLoQ[i];
-            outHiI += t * coeffHiI[i];
-            outHiQ += t * coeffHiQ[i];
+    const tone_set_t *t = det->tones;
+    int32_t outLoI = 0, outLoQ = 0, outHiI = 0, outHiQ = 0; // output values after correlating
+
+    if (det->type == DEMOD_SLIDING_DFT) {
+        // sliding DFT: X(n) = X(n - 1) + x(n) * w(n) - x(n - N) * w(n - N)
+        // w() is a tone oscillator running from a table that holds a whole number of periods of both tones,
+        // so the sums are exact integers and there is no error accumulation
+        uint8_t k = det->sdftIdx;
+        uint8_t ko = det->sdftOldIdx;
+
+        det->sdftLoI += in->out * t->sdftLoI[k] - in->old * t->sdftLoI[ko];
+        det->sdftLoQ += in->out * t->sdftLoQ[k] - in->old * t->sdftLoQ[ko];
+        det->sdftHiI += in->out * t->sdftHiI[k] - in->old * t->sdftHiI[ko];
+        det->sdftHiQ += in->out * t->sdftHiQ[k] - in->old * t->sdftHiQ[ko];
+
+        if (++k == t->sdftPeriod)
+            k = 0;
+        if (++ko == t->sdftPeriod)
+            ko = 0;
+        det->sdftIdx = k;
+        det->sdftOldIdx = ko;
+
+        // X(n) is the reference correlator output rotated by the oscillator phase of the oldest sample in the window
+        // rotate it back, as |I| + |Q| used for tone detection is not phase invariant
+        // ko now points to the oldest sample in the window
+        int32_t loI = det->sdftLoI >> 14, loQ = det->sdftLoQ >> 14;
+        int32_t hiI = det->sdftHiI >> 14, hiQ = det->sdftHiQ >> 14;
+
+        outLoI = (loI * t->sdftLoI[ko] + loQ * t->sdftLoQ[ko]) >> 12;
+        outLoQ = (loQ * t->sdftLoI[ko] - loI * t->sdftLoQ[ko]) >> 12;
+        outHiI = (hiI * t->sdftHiI[ko] + hiQ * t->sdftHiQ[ko]) >> 12;
+        outHiQ = (hiQ * t->sdftHiI[ko] - hiI * t->sdftHiQ[ko]) >> 12;
+    } else {
+        const int16_t *window = &in->window[in->windowIdx]; // oldest sample first, as the coefficients
+
+#ifdef MODEM_FIXED_BAUDRATE
+        for (uint8_t i = 0; i < FIXED_N; i++) { // constant length, unrolled by the compiler
+            outLoI += window[i] * t->coeffLoI[i];
+            outLoQ += window[i] * t->coeffLoQ[i];
+            outHiI += window[i] * t->coeffHiI[i];
+            outHiQ += window[i] * t->coeffHiQ[i];
         }
+#else
+        outLoI = fir_dotprod_s16(t->coeffLoI, window, ctx->N); // correlate samples
+        outLoQ = fir_dotprod_s16(t->coeffLoQ, window, ctx->N);
+        outHiI = fir_dotprod_s16(t->coeffHiI, window, ctx->N);
+        outHiQ = fir_dotprod_s16(t->coeffHiQ, window, ctx->N);
+#endif
 
         outHiI >>= 14;
         outHiQ >>= 14;
         outLoI >>= 14;
         outLoQ >>= 14;
+    }
+
+    int32_t lo = abs(outLoI) + abs(outLoQ);
+    int32_t hi = abs(outHiI) + abs(outHiQ);
+    int32_t sum = (lo + hi) >> 1;
+    *energy = (sum > INT16_MAX) ? INT16_MAX : sum; // half of the total tone energy, for data slicers
+
+    return lo - hi;
+}
+
+/**
+ * @brief Multiply PLL counter by a tuning coefficient
+ * @details Same as ((int64_t)x * tune) >> PLL_TUNE_BITS for 0 <= tune <= 2^PLL_TUNE_BITS, but with 32-bit operations only,
+ * which are available in all SIMD instruction sets
+ * @param x PLL counter
+ * @param tune Tuning coefficient, PLL_TUNE_BITS fractional bits
+ * @return Tuned PLL counter
+ */
+static inline int32_t tunePll(int32_t x, int32_t tune) {
+    return (x >> PLL_TUNE_BITS) * tune + (((x & ((1 << PLL_TUNE_BITS) - 1)) * tune) >> PLL_TUNE_BITS);
+}
+
+/**
+ * @brief Run symbol low-pass filter of all tone detectors and, if any data slicer needs them, of their tone energies
+ * @param[in] *b Demodulator bank with detectorOut set
+ */
+static inline void filterSymbols(demod_bank_t *b) {
+    if (b->lpfPos == 0)
+        b->lpfPos = b->lpfTaps;
+    b->lpfPos--;
+
+    int32_t acc[2 * DEMOD_LANES];
 
-        sample = (abs(outLoI) + abs(outLoQ)) - (abs(outHiI) + abs(outHiQ));
+    for (uint8_t i = 0; i < b->filterLanes; i++) { // store new sample in both halves
+        b->lpfHistory[b->lpfPos][i] = b->detectorOut[i];
+        b->lpfHistory[b->lpfPos + b->lpfTaps][i] = b->detectorOut[i];
     }
 
+    fir_dotprod_lanes_s16(b->lpfCoeffs, b->lpfHistory[b->lpfPos], 2 * DEMOD_LANES, b->lpfTaps, b->filterLanes, acc);
+
+    for (uint8_t i = 0; i < b->filterLanes; i++)
+        b->detectorFiltered[i] = acc[i] >> b->lpfGainShift;
+}
+
+/**
+ * @brief Update DCD state of all demodulators with their tone detector output
+ * @param[in] *ctx Modem context
+ */
+static inline void updateDcd(modem_ctx_t *ctx) {
     // DCD using "PLL"
     // PLL is running nominally at the frequency equal to the baudrate
     // PLL timer is counting up and eventually overflows to a minimal negative value
@@ -462,91 +780,184 @@ static int32_t demodulate(int16_t sample, demod_state_t *dem) {
     // when configured properly, it's generally immune to noise and sensitive to correct signal
     // it's also important to set some maximum value for DCD counter, otherwise the DCD is "sticky"
 
-    dem->dcdPll = (int32_t)((uint32_t)(dem->dcdPll) + (uint32_t)(dem->pllStep)); // keep PLL ticking at the frequency equal to baudrate
+    demod_bank_t *b = &ctx->bank;
+    const int32_t step = (int32_t)symbolStep(ctx);
 
-    if ((sample > 0) != dem->dcdLastSymbol) // tone changed
-    {
-        if ((uint32_t)abs(dem->dcdPll) < (uint32_t)(dem->pllStep)) // tone change occurred near zero
+    for (uint8_t i = 0; i < b->demodLanes; i++) {
+        int32_t symbol = (b->in[i] > 0);
+
+        b->dcdPll[i] = (int32_t)((uint32_t)b->dcdPll[i] + (uint32_t)step); // keep PLL ticking at the frequency equal to baudrate
+
+        if (symbol != b->dcdLastSymbol[i]) // tone changed
         {
-            dem->dcdCounter += dem->dcdInc;    // increase DCD counter
-            if (dem->dcdCounter > dem->dcdMax) // maximum DCD counter value reached
-                dem->dcdCounter = dem->dcdMax; // avoid "sticky" DCD and counter overflow
-        } else                                 // tone change occurred far from zero
+            if ((uint32_t)abs(b->dcdPll[i]) < (uint32_t)step) // tone change occurred near zero
+            {
+                b->dcdCounter[i] += b->dcdInc[i];     // increase DCD counter
+                if (b->dcdCounter[i] > b->dcdMax[i])  // maximum DCD counter value reached
+                    b->dcdCounter[i] = b->dcdMax[i];  // avoid "sticky" DCD and counter overflow
+            } else                                    // tone change occurred far from zero
+            {
+                if (b->dcdCounter[i] >= b->dcdDec[i]) // avoid overflow
+                    b->dcdCounter[i] -= b->dcdDec[i]; // decrease DCD counter
+                else
+                    b->dcdCounter[i] = 0;
+            }
+
+            b->dcdPll[i] = tunePll(b->dcdPll[i], b->dcdTune[i]);
+        }
+
+        b->dcdLastSymbol[i] = symbol;                    // store last symbol for symbol change detection
+        b->dcd[i] = (b->dcdCounter[i] > b->dcdThres[i]); // DCD threshold reached
+    }
+}
+
+/**
+ * @brief Recover bits of all demodulators
+ * @details Synchronized symbols are collected in syncSymbols, recoveredByte() descrambles and decodes them a byte at a time.
+ * @param[in] *ctx Modem context
+ */
+static inline void recoverBits(modem_ctx_t *ctx) {
+    // This function provides bit/clock recovery and NRZI decoding
+    // Bit recovery is based on PLL which is described in the function above (DCD PLL)
+    // Current symbol is sampled at PLL counter overflow, so symbol transition should occur at PLL counter zero
+    demod_bank_t *b = &ctx->bank;
+    const int32_t step = (int32_t)symbolStep(ctx);
+
+    for (uint8_t i = 0; i < b->demodLanes; i++) {
+        int32_t previous = b->pll[i];                                        // store last clock state
+        b->pll[i] = (int32_t)((uint32_t)previous + (uint32_t)step);           // keep PLL running
+        b->rawSymbols[i] = (b->rawSymbols[i] << 1) | (uint32_t)b->symbol[i]; // store received unsynchronized symbol
+
+        if ((b->pll[i] < 0) && (previous > 0)) // PLL counter overflow, sample symbol
         {
-            if (dem->dcdCounter >= dem->dcdDec) // avoid overflow
-                dem->dcdCounter -= dem->dcdDec; // decrease DCD counter
-            else
-                dem->dcdCounter = 0;
+            // take last three symbols for sampling. Seems that 1 symbol is not enough, but 3 symbols work well
+            // if there are 2 or 3 ones, then the received symbol is 1
+            uint32_t raw = b->rawSymbols[i];
+            uint32_t sym = ((raw & (raw >> 1)) | (raw & (raw >> 2)) | ((raw >> 1) & (raw >> 2))) & 1;
+
+            b->syncSymbols[i] = (b->syncSymbols[i] << 1) | sym;
+            b->bitCount[i]++;
         }
 
-        // avoid floating point operations
-        dem->dcdPll = ((int64_t)dem->dcdPll * (int64_t)dem->dcdTune) >> PLL_TUNE_BITS;
+        if ((b->rawSymbols[i] ^ (b->rawSymbols[i] >> 1)) & 1) // if there was a symbol transition, adjust PLL, faster when not locked (no DCD)
+            b->pll[i] = tunePll(b->pll[i], b->dcd[i] ? b->pllLockedTune[i] : b->pllNotLockedTune[i]);
     }
+}
+
+/**
+ * @brief Take the last 8 synchronized symbols of a demodulator: descrambling and NRZI decoding
+ * @param[in] *ctx Modem context
+ * @param demod Demodulator index (bank lane)
+ * @return Decoded bits, first received in bit 0
+ */
+static inline uint8_t recoveredByte(modem_ctx_t *ctx, uint8_t demod) {
+    demod_bank_t *b = &ctx->bank;
+    uint32_t symbols = b->syncSymbols[demod] & 0xFF; // last received in bit 0
 
-    dem->dcdLastSymbol = sample > 0; // store last symbol for symbol change detection
+    if (isBaseband(ctx)) // G3RUH descrambling (x^17+x^12+1), all 8 symbols at once
+        symbols = g3ruh_descramble_word(&b->lfsr[demod], symbols, 8);
 
-    if (dem->dcdCounter > dem->dcdThres) // DCD threshold reached
-        dem->dcd = 1;                    // DCD!
-    else                                 // below DCD threshold
-        dem->dcd = 0;                    // no DCD
+    // NRZI decoding: two last symbols are the same - no symbol transition - decoded bit 1
+    uint32_t decoded = ~(symbols ^ (((b->lastSymbol[demod] << 8) | symbols) >> 1)) & 0xFF;
 
-    return filter(&dem->lpf, sample) > 0;
+    b->lastSymbol[demod] = symbols & 1;
+    b->bitCount[demod] = 0;
+    return bit_reverse_table[decoded];
 }
 
 /**
- * @brief Decode received symbol: bit recovery, NRZI decoding and pass the decoded bit to higher level protocol
- * @param[in] symbol Received symbol
- * @param demod Demodulator index
+ * @brief Goertzel power of one tone, resets the filter state
+ * @param[in,out] *s Goertzel filter state
+ * @param coeff Goertzel coefficient, Q14
+ * @return Tone power, scaled
  */
-static void decode(uint8_t symbol, uint8_t demod, uint16_t mV) {
-    demod_state_t *dem = (demod_state_t *)&demodState[demod];
+static int64_t surveyPower(int32_t *s, int32_t coeff) {
+    int64_t power = (int64_t)s[0] * s[0] + (int64_t)s[1] * s[1] - (((int64_t)coeff * s[0] * s[1]) >> 14);
+    s[0] = 0;
+    s[1] = 0;
+    return power;
+}
 
-    // This function provides bit/clock recovery and NRZI decoding
-    // Bit recovery is based on PLL which is described in the function above (DCD PLL)
-    // Current symbol is sampled at PLL counter overflow, so symbol transition should occur at PLL counter zero
-    int32_t previous = dem->pll; // store last clock state
+/**
+ * @brief Measure tone energies of all correlators and keep only the ones with the highest energy active
+ * @details The correlator window is one symbol long, too short to tell offsets apart, so tone energies are measured by Goertzel
+ * filters over MODEM_SURVEY_SYMBOLS symbols instead, at two multiply-accumulates per tone and sample.
+ * Correlators have no state besides the shared sample window, so they can be stopped and restarted at any time.
+ * The selection is kept while any demodulator has DCD, and an active correlator keeps its place unless another one has
+ * at least 1.5 times its energy, as correlators next to each other have similar energies and restarting one loses its frame.
+ * @param[in] *ctx Modem context
+ */
+static inline void surveyTones(modem_ctx_t *ctx) {
+    for (uint8_t i = 0; i < ctx->detectorCount; i++) {
+        detector_t *det = &ctx->detectors[i];
+        if (det->type != DEMOD_CORRELATOR)
+            continue;
+
+        int32_t x = ctx->inputs[det->input].out >> 5; // keep Goertzel state within 16 bits
+        int32_t m = x + ((det->tones->surveyMark * det->surveyMark[0]) >> 14) - det->surveyMark[1];
+        int32_t p = x + ((det->tones->surveySpace * det->surveySpace[0]) >> 14) - det->surveySpace[1];
+        det->surveyMark[1] = det->surveyMark[0];
+        det->surveyMark[0] = m;
+        det->surveySpace[1] = det->surveySpace[0];
+        det->surveySpace[0] = p;
+    }
 
-    dem->pll = (int32_t)((uint32_t)(dem->pll) + (uint32_t)(dem->pllStep)); // keep PLL running
+    if (++ctx->surveyCounter < (MODEM_SURVEY_SYMBOLS * symbolSamples(ctx)))
+        return;
+    ctx->surveyCounter = 0;
 
-    dem->rawSymbols <<= 1; // store received unsynchronized symbol
-    dem->rawSymbols |= (symbol & 1);
+    for (uint8_t i = 0; i < ctx->detectorCount; i++) {
+        detector_t *det = &ctx->detectors[i];
+        if (det->type != DEMOD_CORRELATOR)
+            continue;
 
-    if ((dem->pll < 0) && (previous > 0)) // PLL counter overflow, sample symbol, decode NRZI and process in higher layer
-    {
-        dem->syncSymbols <<= 1; // shift recovered (received, synchronized) bit register
+        int64_t power = surveyPower(det->surveyMark, det->tones->surveyMark) + surveyPower(det->surveySpace, det->tones->surveySpace);
+        det->level += (power - det->level) / 4; // average over a few surveys
+    }
 
-        uint8_t sym = dem->rawSymbols & 0x07; // take last three symbols for sampling. Seems that 1 symbol is not enough, but 3 symbols work well
-        if (sym == 0b111 || sym == 0b110 || sym == 0b101 || sym == 0b011) // if there are 2 or 3 ones, then the received symbol is 1
-            sym = 1;
-        else
-            sym = 0;
+    for (uint8_t k = 0; k < ctx->demodCount; k++) { // never switch in the middle of a frame
+        if (ctx->bank.dcd[k])
+            return;
+    }
 
-        if (ModemConfig.modem == MODEM_9600)
-            sym = descramble(sym); // descramble
+    bool selected[MODEM_MAX_DEMODULATOR_COUNT] = {false};
 
-        dem->syncSymbols |= sym;
+    for (uint8_t n = 0; n < ctx->selectCount; n++) {
+        int64_t best = -1;
+        uint8_t bestIdx = 0;
 
-        // NRZI decoding
-        if (((dem->syncSymbols & 0x03) == 0b11) || ((dem->syncSymbols & 0x03) == 0b00)) // two last symbols are the same - no symbol transition - decoded bit 1
-        {
+        for (uint8_t i = 0; i < ctx->detectorCount; i++) {
+            const detector_t *det = &ctx->detectors[i];
+            if (selected[i] || (det->type != DEMOD_CORRELATOR))
+                continue;
 
-            ax25_bit_parse(1, demod, mV);
-        } else // symbol transition - decoded bit 0
-        {
-            ax25_bit_parse(0, demod, mV);
+            int64_t level = det->level;
+            if (det->active)
+                level += level / 2; // hysteresis
+            if (level > best) {
+                best = level;
+                bestIdx = i;
+            }
         }
+        if (best < 0) // fewer correlators than selectCount
+            break;
+        selected[bestIdx] = true;
     }
 
-    if (((dem->rawSymbols & 0x03) == 0b10) || ((dem->rawSymbols & 0x03) == 0b01)) // if there was a symbol transition, adjust PLL
-    {
-        // avoid floating point operations. Multiply by n-bit value and shift by n bits
-        if (!dem->dcd) // PLL not locked
-        {
-            dem->pll = ((int64_t)dem->pll * (int64_t)dem->pllNotLockedTune) >> PLL_TUNE_BITS; // adjust PLL faster
-        } else                                                                                // PLL locked
-        {
-            dem->pll = ((int64_t)dem->pll * (int64_t)dem->pllLockedTune) >> PLL_TUNE_BITS; // adjust PLL slower
+    for (uint8_t i = 0; i < ctx->detectorCount; i++) {
+        detector_t *det = &ctx->detectors[i];
+        if (det->type != DEMOD_CORRELATOR)
+            continue; // other detectors have running sums and are never stopped
+
+        if (det->active && !selected[i]) {
+            for (uint8_t k = 0; k < ctx->demodCount; k++) {
+                if (ctx->bank.detector[k] == i) {
+                    ctx->bank.dcdCounter[k] = 0;
+                    ctx->bank.dcd[k] = 0;
+                }
+            }
         }
+        det->active = selected[i];
     }
 }
 
@@ -592,131 +1003,470 @@ void modem_transmit_stop(void) {
 }
 
 /**
- * @brief Initialize AFSK module
+ * @brief Calculate correlator coefficients for given tones
+ * @details Same formulas as the constant tables generated by tools/gen_tables.py
+ * @param *t Tone set to fill
+ * @param N Samples per symbol
+ * @param baudRate Baudrate
+ * @param mark Mark tone frequency
+ * @param space Space tone frequency
  */
-void modem_init(void) {
-    memset(demodState, 0, sizeof(demodState));
-
-    if (ModemConfig.modem > MODEM_9600)
-        ModemConfig.modem = MODEM_1200;
-
-    if ((ModemConfig.modem == MODEM_1200) || (ModemConfig.modem == MODEM_1200_V23)) {
-        demodCount = 2;
-        N = N1200;
-        baudRate = 1200.f;
-
-        demodState[0].pllStep = PLL1200_STEP;
-        demodState[0].pllLockedTune = PLL1200_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].pllNotLockedTune = PLL1200_NOT_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].dcdMax = DCD1200_MAXPULSE;
-        demodState[0].dcdThres = DCD1200_THRES;
-        demodState[0].dcdInc = DCD1200_INC;
-        demodState[0].dcdDec = DCD1200_DEC;
-        demodState[0].dcdTune = DCD1200_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-
-        demodState[1].pllStep = PLL1200_STEP;
-        demodState[1].pllLockedTune = PLL1200_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[1].pllNotLockedTune = PLL1200_NOT_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[1].dcdMax = DCD1200_MAXPULSE;
-        demodState[1].dcdThres = DCD1200_THRES;
-        demodState[1].dcdInc = DCD1200_INC;
-        demodState[1].dcdDec = DCD1200_DEC;
-        demodState[1].dcdTune = DCD1200_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-
-        demodState[1].prefilter = PREFILTER_NONE;
-        demodState[1].lpf.coeffs = (int16_t *)lpf1200;
-        demodState[1].lpf.taps = sizeof(lpf1200) / sizeof(*lpf1200);
-        demodState[1].lpf.gainShift = 15;
-
-        demodState[0].lpf.coeffs = (int16_t *)lpf1200;
-        demodState[0].lpf.taps = sizeof(lpf1200) / sizeof(*lpf1200);
-        demodState[0].lpf.gainShift = 15;
-        demodState[0].prefilter = PREFILTER_NONE;
-
-        if (ModemConfig.flatAudioIn) // when used with flat audio input, use deemphasis and flat modems
+static void calculateToneSet(tone_set_t *t, uint8_t N, float baudRate, float mark, float space) {
+    t->markFreq = mark;
+    t->spaceFreq = space;
+    t->baudRate = baudRate;
+    t->N = N;
+
+    for (uint8_t i = 0; i < N; i++) // calculate correlator coefficients
+    {
+        t->coeffLoI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i / (float)N * mark / baudRate);
+        t->coeffLoQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i / (float)N * mark / baudRate);
+        t->coeffHiI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i / (float)N * space / baudRate);
+        t->coeffHiQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i / (float)N * space / baudRate);
+    }
+
+    // sliding DFT oscillator table must hold a whole number of periods of both tones
+    uint32_t fs = (uint32_t)N * (uint32_t)baudRate;
+
+    t->surveyMark = 2.f * 16384.f * cosf(2.f * 3.1416f * mark / (float)fs);
+    t->surveySpace = 2.f * 16384.f * cosf(2.f * 3.1416f * space / (float)fs);
+    uint32_t period = fs / gcd(fs, gcd((uint32_t)mark, (uint32_t)space));
+
+    t->sdftPeriod = 0;
+    if ((mark == (uint32_t)mark) && (space == (uint32_t)space) && (period <= TONE_SDFT_MAX_PERIOD)) {
+        t->sdftPeriod = period;
+        for (uint8_t i = 0; i < t->sdftPeriod; i++) {
+            t->sdftLoI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i * mark / (float)fs);
+            t->sdftLoQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i * mark / (float)fs);
+            t->sdftHiI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i * space / (float)fs);
+            t->sdftHiQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i * space / (float)fs);
+        }
+    }
+}
+
+/**
+ * @brief Get correlator coefficients for given tones
+ * @details Default tones of every modem use the constant tables, other tones (e.g. of an offset bank) are calculated once
+ * and shared by all demodulators using them.
+ * @param *ctx Modem context
+ * @param mark Mark tone frequency
+ * @param space Space tone frequency
+ * @return Tone set
+ */
+static const tone_set_t *getToneSet(modem_ctx_t *ctx, float mark, float space) {
+    for (uint8_t i = 0; i < ctx->toneSetCount; i++) {
+        if ((ctx->toneSets[i]->markFreq == mark) && (ctx->toneSets[i]->spaceFreq == space))
+            return ctx->toneSets[i];
+    }
+
+    const tone_set_t *t = NULL;
+    for (uint8_t i = 0; i < tone_table_count; i++) {
+        const tone_set_t *table = &tone_tables[i];
+        if ((table->N == ctx->N) && (table->baudRate == ctx->baudRate) && (table->markFreq == mark) && (table->spaceFreq == space)) {
+            t = table;
+            break;
+        }
+    }
+
+    if (t == NULL) // there is at most one tone set per demodulator
+    {
+        tone_set_t *calculated = &ctx->toneStore[ctx->toneSetCount];
+        calculateToneSet(calculated, ctx->N, ctx->baudRate, mark, space);
+        t = calculated;
+    }
+
+    ctx->toneSets[ctx->toneSetCount++] = t;
+    return t;
+}
+
+/**
+ * @brief Choose delay line discriminator delay for the demodulator tones
+ * @details The delay with the largest difference of cos(2 pi f d / fs) between mark and space is used, the shortest one on a tie.
+ * This gives d=4 for 1200/2200 Hz and 1300/2100 Hz at 9600 Hz and d=24 for 1600/1800 Hz.
+ * @param *ctx Modem context
+ * @param *det Tone detector state with tones set
+ */
+static void setDelayLine(const modem_ctx_t *ctx, detector_t *det) {
+    float fs = (float)ctx->N * ctx->baudRate;
+    float best = 0.f;
+
+    det->delay = 1;
+    for (uint8_t d = 1; d < ctx->N; d++) {
+        float diff = cosf(2.f * 3.1416f * det->tones->markFreq * (float)d / fs) - cosf(2.f * 3.1416f * det->tones->spaceFreq * (float)d / fs);
+        if (fabsf(diff) > (fabsf(best) + 0.001f)) {
+            best = diff;
+            det->delay = d;
+        }
+    }
+    det->delayInvert = (best < 0.f);
+
+    det->delayShift = 0;
+    while (((uint32_t)1 << det->delayShift) < ctx->N)
+        det->delayShift++;
+}
+
+void modem_get_default_demodulator(modem_prefilter_t prefilter, modem_demod_params_t *params) {
+    modem_ctx_get_default_demodulator(&defaultCtx, prefilter, params);
+}
+
+void modem_ctx_get_default_demodulator(const modem_ctx_t *ctx, modem_prefilter_t prefilter, modem_demod_params_t *params) {
+    memset(params, 0, sizeof(*params));
+    params->type = ctx->config.demodType;
+    params->prefilter = prefilter;
+
+    if (ctx->config.modem == MODEM_300) {
+        params->pllLockedTune = PLL300_LOCKED_TUNE;
+        params->pllNotLockedTune = PLL300_NOT_LOCKED_TUNE;
+        params->dcdMax = DCD300_MAXPULSE;
+        params->dcdThres = DCD300_THRES;
+        params->dcdInc = DCD300_INC;
+        params->dcdDec = DCD300_DEC;
+        params->dcdTune = DCD300_TUNE;
+    } else if (ctx->config.modem == MODEM_9600) {
+        params->pllLockedTune = PLL9600_LOCKED_TUNE;
+        params->pllNotLockedTune = PLL9600_NOT_LOCKED_TUNE;
+        params->dcdMax = DCD9600_MAXPULSE;
+        params->dcdThres = DCD9600_THRES;
+        params->dcdInc = DCD9600_INC;
+        params->dcdDec = DCD9600_DEC;
+        params->dcdTune = DCD9600_TUNE;
+    } else {
+        params->pllLockedTune = PLL1200_LOCKED_TUNE;
+        params->pllNotLockedTune = PLL1200_NOT_LOCKED_TUNE;
+        params->dcdMax = DCD1200_MAXPULSE;
+        params->dcdThres = DCD1200_THRES;
+        params->dcdInc = DCD1200_INC;
+        params->dcdDec = DCD1200_DEC;
+        params->dcdTune = DCD1200_TUNE;
+    }
+}
+
+/**
+ * @brief Get input stage for given prefilter, set it up if not used by any demodulator yet
+ * @param *ctx Modem context
+ * @param prefilter Input filter type
+ * @return Input stage index
+ */
+static uint8_t getInputStage(modem_ctx_t *ctx, modem_prefilter_t prefilter) {
+    for (uint8_t i = 0; i < ctx->inputCount; i++) {
+        if (ctx->inputs[i].prefilter == prefilter)
+            return i;
+    }
+
+    input_stage_t *in = &ctx->inputs[ctx->inputCount]; // there is at most one input stage per demodulator
+    memset(in, 0, sizeof(*in));
+    in->prefilter = prefilter;
+
+    if (prefilter == PREFILTER_FLAT)
+        fir_engine_init(&in->bpf, bpf300, sizeof(bpf300) / sizeof(*bpf300), 16);
+    else if (prefilter == PREFILTER_PREEMPHASIS)
+        fir_engine_init(&in->bpf, bpf1200, sizeof(bpf1200) / sizeof(*bpf1200), 15);
+    else if (prefilter == PREFILTER_DEEMPHASIS)
+        fir_engine_init(&in->bpf, bpf1200Inv, sizeof(bpf1200Inv) / sizeof(*bpf1200Inv), 15);
+
+    return ctx->inputCount++;
+}
+
+/**
+ * @brief Get tone detector for given input stage, tones and detector type, set it up if not used by any demodulator yet
+ * @param *ctx Modem context
+ * @param input Input stage index
+ * @param *tones Tone set, NULL for 9600 Bd baseband
+ * @param type Tone detector type, must be usable with the tone set
+ * @return Tone detector index
+ */
+static uint8_t getDetector(modem_ctx_t *ctx, uint8_t input, const tone_set_t *tones, modem_demod_type_t type) {
+    for (uint8_t i = 0; i < ctx->detectorCount; i++) {
+        const detector_t *det = &ctx->detectors[i];
+        if ((det->input == input) && (det->tones == tones) && (det->type == type))
+            return i;
+    }
+
+    detector_t *det = &ctx->detectors[ctx->detectorCount]; // there is at most one detector per demodulator
+    memset(det, 0, sizeof(*det));
+    det->input = input;
+    det->tones = tones;
+    det->type = type;
+    det->active = true;
+
+    if (type == DEMOD_SLIDING_DFT) {
+        det->sdftIdx = 0;
+        det->sdftOldIdx = (tones->sdftPeriod - (ctx->N % tones->sdftPeriod)) % tones->sdftPeriod; // table index of the sample N samples back
+    } else if (type == DEMOD_DELAY_LINE)
+        setDelayLine(ctx, det);
+
+    return ctx->detectorCount++;
+}
+
+/**
+ * @brief Configure demodulator
+ * @details Input filter and tone detector are shared with other demodulators using the same prefilter, tones and detector type,
+ * only bit recovery and DCD are private to the demodulator.
+ * @param *ctx Modem context
+ * @param demod Demodulator index (bank lane), the bank must be cleared
+ * @param *params Demodulator parameters
+ */
+static void initDemodulator(modem_ctx_t *ctx, uint8_t demod, const modem_demod_params_t *params) {
+    demod_bank_t *b = &ctx->bank;
+
+    b->pllLockedTune[demod] = params->pllLockedTune * (float)((uint32_t)1 << PLL_TUNE_BITS);
+    b->pllNotLockedTune[demod] = params->pllNotLockedTune * (float)((uint32_t)1 << PLL_TUNE_BITS);
+    b->dcdMax[demod] = params->dcdMax;
+    b->dcdThres[demod] = params->dcdThres;
+    b->dcdInc[demod] = params->dcdInc;
+    b->dcdDec[demod] = params->dcdDec;
+    b->dcdTune[demod] = params->dcdTune * (float)((uint32_t)1 << PLL_TUNE_BITS);
+    b->lfsr[demod] = G3RUH_LFSR_INIT;
+
+    float level = params->slicerLevel;
+    if (level > 1.f)
+        level = 1.f;
+    else if (level < -1.f)
+        level = -1.f;
+    b->slicerLevel[demod] = level * (float)INT16_MAX;
+
+    modem_prefilter_t prefilter = PREFILTER_NONE;
+    if (ctx->config.modem == MODEM_300) {
+        if (params->prefilter != PREFILTER_NONE) // only flat band pass filter is available for 300 Bd
+            prefilter = PREFILTER_FLAT;
+    } else if (ctx->config.modem == MODEM_9600) {
+        b->detector[demod] = getDetector(ctx, getInputStage(ctx, PREFILTER_NONE), NULL, DEMOD_CORRELATOR);
+        return; // no tone detection in 9600 Bd
+    } else if ((params->prefilter == PREFILTER_PREEMPHASIS) || (params->prefilter == PREFILTER_DEEMPHASIS))
+        prefilter = params->prefilter;
+
+    const tone_set_t *tones = getToneSet(ctx, ctx->markFreq + params->markOffset, ctx->spaceFreq + params->spaceOffset);
+
+    modem_demod_type_t type = DEMOD_CORRELATOR;
+    if (params->type == DEMOD_DELAY_LINE)
+        type = DEMOD_DELAY_LINE;
+    else if (params->type == DEMOD_SLIDING_DFT) {
+        if (tones->sdftPeriod > 0)
+            type = DEMOD_SLIDING_DFT;
+        else
+            log_i(TAG, "sliding DFT not available for %d/%d Hz, using correlator", (int)tones->markFreq, (int)tones->spaceFreq);
+    }
+
+    b->detector[demod] = getDetector(ctx, getInputStage(ctx, prefilter), tones, type);
+}
+
+bool modem_set_demodulators(const modem_demod_params_t *params, uint8_t count) {
+    return modem_ctx_set_demodulators(&defaultCtx, params, count);
+}
+
+bool modem_set_offset_bank(const modem_demod_params_t *params, const int16_t *offsets, uint8_t count, uint8_t active) {
+    return modem_ctx_set_offset_bank(&defaultCtx, params, offsets, count, active);
+}
+
+bool modem_ctx_set_offset_bank(modem_ctx_t *ctx, const modem_demod_params_t *params, const int16_t *offsets, uint8_t count, uint8_t active) {
+    modem_demod_params_t bank[MODEM_MAX_DEMODULATOR_COUNT];
+
+    if ((count == 0) || (count > MODEM_MAX_DEMODULATOR_COUNT))
+        return false;
+
+    for (uint8_t i = 0; i < count; i++) { // all demodulators share the input filter and its correlator window
+        bank[i] = *params;
+        bank[i].markOffset = offsets[i];
+        bank[i].spaceOffset = offsets[i];
+    }
+
+    if (!modem_ctx_set_demodulators(ctx, bank, count))
+        return false;
+
+    if (active < count)
+        ctx->selectCount = active; // all correlators run until the end of the first survey
+    return true;
+}
+
+bool modem_set_slicers(const modem_demod_params_t *params, const float *levels, uint8_t count) {
+    return modem_ctx_set_slicers(&defaultCtx, params, levels, count);
+}
+
+bool modem_ctx_set_slicers(modem_ctx_t *ctx, const modem_demod_params_t *params, const float *levels, uint8_t count) {
+    modem_demod_params_t slicers[MODEM_MAX_DEMODULATOR_COUNT];
+
+    if ((count == 0) || (count > MODEM_MAX_DEMODULATOR_COUNT))
+        return false;
+
+    for (uint8_t i = 0; i < count; i++) { // identical demodulators share one tone detector, only the slicer level differs
+        slicers[i] = *params;
+        slicers[i].slicerLevel = levels[i];
+    }
+
+    return modem_ctx_set_demodulators(ctx, slicers, count);
+}
+
+bool modem_ctx_set_demodulators(modem_ctx_t *ctx, const modem_demod_params_t *params, uint8_t count) {
+    if ((count == 0) || (count > MODEM_MAX_DEMODULATOR_COUNT))
+        return false;
+
+    ctx->toneSetCount = 0;
+    ctx->inputCount = 0;
+    ctx->detectorCount = 0;
+    ctx->selectCount = 0;
+    ctx->surveyCounter = 0;
+    ctx->peak = 0;
+    ctx->valley = 0;
+    ctx->pllStep = ((uint64_t)1 << 32) / ctx->N;
+
+    demod_bank_t *b = &ctx->bank;
+    memset(b, 0, sizeof(*b));
+
+    const int16_t *lpf = lpf1200;
+    uint8_t taps = sizeof(lpf1200) / sizeof(*lpf1200);
+    b->lpfGainShift = 15;
+    if (ctx->config.modem == MODEM_300) {
+        lpf = lpf300;
+        taps = sizeof(lpf300) / sizeof(*lpf300);
+    } else if (ctx->config.modem == MODEM_9600) {
+        lpf = lpf9600;
+        taps = sizeof(lpf9600) / sizeof(*lpf9600);
+        b->lpfGainShift = 16;
+    }
+    memcpy(b->lpfCoeffs, lpf, taps * sizeof(*lpf));
+    b->lpfTaps = taps;
+
+    bool slicing = false;
+    for (uint8_t i = 0; i < count; i++) {
+        initDemodulator(ctx, i, &params[i]);
+        if (b->slicerLevel[i] != 0)
+            slicing = true;
+    }
+
+    b->demodLanes = count;
+    b->detectorLanes = (ctx->detectorCount + DEMOD_LANE_GROUP - 1) / DEMOD_LANE_GROUP * DEMOD_LANE_GROUP;
+    b->filterLanes = slicing ? (2 * b->detectorLanes) : b->detectorLanes; // tone energies are filtered only when they are used
+
+    if (ctx->rx != NULL)
+        ax25_rx_reset_decoders(ctx->rx, count); // decoders left without a demodulator would hold their frame store spans forever
+    ctx->demodCount = count;
+    ctx->dcd = 0;
+    return true;
+}
+
+/**
+ * @brief Map a requested modem type to one this build can run
+ * @param modem Requested modem type
+ * @return Requested type if supported, otherwise the default (or the only built) modem
+ */
+static modem_type_t builtModem(modem_type_t modem) {
+#if MODEM_FIXED_BAUDRATE == 1200
+    if ((modem == MODEM_1200) || (modem == MODEM_1200_V23))
+        return modem;
+#elif defined(MODEM_FIXED_BAUDRATE)
+    if (modem == FIXED_MODEM)
+        return modem;
+#else
+    if (modem <= MODEM_9600)
+        return modem;
+#endif
+    log_i(TAG, "modem %d not available, using %d", (int)modem, (int)FIXED_MODEM);
+    return FIXED_MODEM;
+}
+
+/**
+ * @brief Configure modem context and set up its default demodulators
+ * @param *ctx Modem context
+ * @param *config Modem configuration
+ */
+static void configure(modem_ctx_t *ctx, const modem_demod_config_t *config) {
+    modem_demod_params_t params[2];
+    uint8_t count = 1;
+
+    memset(&ctx->bank, 0, sizeof(ctx->bank));
+    ctx->config = *config;
+
+    ctx->config.modem = builtModem(ctx->config.modem);
+
+    if ((ctx->config.modem == MODEM_1200) || (ctx->config.modem == MODEM_1200_V23)) {
+        ctx->N = N1200;
+        ctx->baudRate = 1200.f;
+
+        if (ctx->config.modem == MODEM_1200) // Bell 202
+        {
+            ctx->markFreq = 1200.f;
+            ctx->spaceFreq = 2200.f;
+        } else // V.23
+        {
+            ctx->markFreq = 1300.f;
+            ctx->spaceFreq = 2100.f;
+        }
+
+        if (ctx->config.flatAudioIn) // when used with flat audio input, use deemphasis and flat modems
         {
 #ifdef ENABLE_FX25
             if (Ax25Config.fx25)
-                demodState[0].prefilter = PREFILTER_NONE;
+                modem_ctx_get_default_demodulator(ctx, PREFILTER_NONE, &params[0]);
             else
 #endif
-                demodState[0].prefilter = PREFILTER_DEEMPHASIS;
-            demodState[0].bpf.coeffs = (int16_t *)bpf1200Inv;
-            demodState[0].bpf.taps = sizeof(bpf1200Inv) / sizeof(*bpf1200Inv);
-            demodState[0].bpf.gainShift = 15;
+                modem_ctx_get_default_demodulator(ctx, PREFILTER_DEEMPHASIS, &params[0]);
         } else // when used with normal (filtered) audio input, use flat and preemphasis modems
         {
-            demodState[0].prefilter = PREFILTER_PREEMPHASIS;
-            demodState[0].bpf.coeffs = (int16_t *)bpf1200;
-            demodState[0].bpf.taps = sizeof(bpf1200) / sizeof(*bpf1200);
-            demodState[0].bpf.gainShift = 15;
+            modem_ctx_get_default_demodulator(ctx, PREFILTER_PREEMPHASIS, &params[0]);
         }
+        modem_ctx_get_default_demodulator(ctx, PREFILTER_NONE, &params[1]);
+        count = 2;
+    } else if (ctx->config.modem == MODEM_300) {
+        ctx->N = N300;
+        ctx->baudRate = 300.f;
+        ctx->markFreq = 1600.f;
+        ctx->spaceFreq = 1800.f;
+
+        modem_ctx_get_default_demodulator(ctx, PREFILTER_FLAT, &params[0]);
+    } else if (ctx->config.modem == MODEM_9600) {
+        ctx->N = N9600;
+        ctx->baudRate = 9600.f;
+        ctx->markFreq = 38400.f / (float)DAC_SINE_SIZE; // use as DAC sample rate
+        ctx->spaceFreq = 0.f;
+
+        modem_ctx_get_default_demodulator(ctx, PREFILTER_NONE, &params[0]);
+    }
 
-        if (ModemConfig.modem == MODEM_1200) // Bell 202
-        {
-            markFreq = 1200.f;
-            spaceFreq = 2200.f;
-        } else // V.23
-        {
-            markFreq = 1300.f;
-            spaceFreq = 2100.f;
-        }
-    } else if (ModemConfig.modem == MODEM_300) {
-        demodCount = 1;
-        N = N300;
-        baudRate = 300.f;
-        markFreq = 1600.f;
-        spaceFreq = 1800.f;
-
-        demodState[0].pllStep = PLL300_STEP;
-        demodState[0].pllLockedTune = PLL300_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].pllNotLockedTune = PLL300_NOT_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].dcdMax = DCD300_MAXPULSE;
-        demodState[0].dcdThres = DCD300_THRES;
-        demodState[0].dcdInc = DCD300_INC;
-        demodState[0].dcdDec = DCD300_DEC;
-        demodState[0].dcdTune = DCD300_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-
-        demodState[0].prefilter = PREFILTER_FLAT;
-        demodState[0].bpf.coeffs = (int16_t *)bpf300;
-        demodState[0].bpf.taps = sizeof(bpf300) / sizeof(*bpf300);
-        demodState[0].bpf.gainShift = 16;
-        demodState[0].lpf.coeffs = (int16_t *)lpf300;
-        demodState[0].lpf.taps = sizeof(lpf300) / sizeof(*lpf300);
-        demodState[0].lpf.gainShift = 15;
-    } else if (ModemConfig.modem == MODEM_9600) {
-        demodCount = 1;
-        N = N9600;
-        baudRate = 9600.f;
-        markFreq = 38400.f / (float)DAC_SINE_SIZE; // use as DAC sample rate
-
-        demodState[0].pllStep = PLL9600_STEP;
-        demodState[0].pllLockedTune = PLL9600_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].pllNotLockedTune = PLL9600_NOT_LOCKED_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-        demodState[0].dcdMax = DCD9600_MAXPULSE;
-        demodState[0].dcdThres = DCD9600_THRES;
-        demodState[0].dcdInc = DCD9600_INC;
-        demodState[0].dcdDec = DCD9600_DEC;
-        demodState[0].dcdTune = DCD9600_TUNE * (float)((uint32_t)1 << PLL_TUNE_BITS);
-
-        demodState[0].prefilter = PREFILTER_NONE;
-        // this filter will be used for RX and TX
-        demodState[0].lpf.coeffs = (int16_t *)lpf9600;
-        demodState[0].lpf.taps = sizeof(lpf9600) / sizeof(*lpf9600);
-        demodState[0].lpf.gainShift = 16;
+    modem_ctx_set_demodulators(ctx, params, (count < MODEM_MAX_DEMODULATOR_COUNT) ? count : MODEM_MAX_DEMODULATOR_COUNT);
+}
+
+modem_ctx_t *modem_ctx_create(const modem_demod_config_t *config) {
+    modem_ctx_t *ctx = calloc(1, sizeof(modem_ctx_t));
+    if (ctx == NULL)
+        return NULL;
+
+    ctx->rx = ax25_rx_create(ctx);
+    if (ctx->rx == NULL) {
+        free(ctx);
+        return NULL;
     }
 
+    configure(ctx, config);
+    return ctx;
+}
+
+void modem_ctx_destroy(modem_ctx_t *ctx) {
+    if ((ctx == NULL) || (ctx == &defaultCtx))
+        return;
+
+    ax25_rx_destroy(ctx->rx);
+    free(ctx);
+}
+
+/**
+ * @brief Initialize AFSK module
+ */
+void modem_init(void) {
+    ModemConfig.modem = builtModem(ModemConfig.modem);
+
+    defaultCtx.rx = ax25_get_default_rx();
+    defaultCtx.statusLed = true;
+    configure(&defaultCtx, &ModemConfig);
+
+    // TX always runs on the default context settings
+    baudRate = defaultCtx.baudRate;
+    markFreq = defaultCtx.markFreq;
+    spaceFreq = defaultCtx.spaceFreq;
+
     markStep = (uint16_t)(DIV_ROUND(SIN_LEN * (uint32_t)markFreq, CONFIG_AFSK_DAC_SAMPLERATE));
     spaceStep = (uint16_t)(DIV_ROUND(SIN_LEN * (uint32_t)spaceFreq, CONFIG_AFSK_DAC_SAMPLERATE));
     baudRateStep = CONFIG_AFSK_DAC_SAMPLERATE / (uint32_t)baudRate;
+    txLfsr = G3RUH_LFSR_INIT;
 
     log_i(TAG, "markStep %d spaceStep %d baudRateStep %d", markStep, spaceStep, baudRateStep);
-
-    for (uint8_t i = 0; i < N; i++) // calculate correlator coefficients
-    {
-        coeffLoI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i / (float)N * markFreq / baudRate);
-        coeffLoQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i / (float)N * markFreq / baudRate);
-        coeffHiI[i] = 4095.f * cosf(2.f * 3.1416f * (float)i / (float)N * spaceFreq / baudRate);
-        coeffHiQ[i] = 4095.f * sinf(2.f * 3.1416f * (float)i / (float)N * spaceFreq / baudRate);
-    }
 }
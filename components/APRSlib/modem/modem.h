@@ -30,12 +30,33 @@
 #define DRIVERS_MODEM_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // number of maximum parallel demodulators
-// each demodulator must be explicitly configured in code
-// currently used only for 1200 Bd modem
+// modem_init() configures the default demodulators (2 for 1200 Bd, 1 for other modems),
+// more can be set up with modem_set_demodulators(). Can be overridden at build time, up to 32
+#ifndef MODEM_MAX_DEMODULATOR_COUNT
 #define MODEM_MAX_DEMODULATOR_COUNT 2
+#endif
+
+#if MODEM_MAX_DEMODULATOR_COUNT > 32
+#error "MODEM_MAX_DEMODULATOR_COUNT must not exceed 32"
+#endif
+
+// build the modem for one baudrate only: 1200 (Bell 202 and V.23), 300 or 9600
+// samples per symbol are constant, correlators are unrolled and there are no modem type branches in the per-sample and per-bit paths.
+// Other modem types fall back to the built one. Set by the "Modem decoder build" option in menuconfig, leave undefined for a generic build
+// #define MODEM_FIXED_BAUDRATE 1200
+
+#if defined(MODEM_FIXED_BAUDRATE) && (MODEM_FIXED_BAUDRATE != 1200) && (MODEM_FIXED_BAUDRATE != 300) && (MODEM_FIXED_BAUDRATE != 9600)
+#error "MODEM_FIXED_BAUDRATE must be 1200, 300 or 9600"
+#endif
+
+typedef uint32_t modem_demod_mask_t; // bitmap with one bit per demodulator
+
+typedef struct ModemCtx_s modem_ctx_t; // receiver instance: demodulators, their configuration and frame decoder
+struct Ax25Rx_s;
 
 typedef enum ModemType_e {
     MODEM_1200,
@@ -51,8 +72,15 @@ typedef enum ModemTxTestMode_e {
     TEST_ALTERNATING,
 } modem_tx_test_mode_t;
 
+typedef enum ModemDemodType_e {
+    DEMOD_CORRELATOR,  // reference I/Q correlator, N multiply-accumulates per tone and sample
+    DEMOD_SLIDING_DFT, // recursive sliding DFT, constant cost per sample regardless of N
+    DEMOD_DELAY_LINE,  // delay-and-multiply FM discriminator, one multiply per sample, for low power receivers
+} modem_demod_type_t;
+
 typedef struct ModemDemodConfig_s {
     modem_type_t modem;
+    modem_demod_type_t demodType; // AFSK tone detector type
     bool usePWM;      // 0 - use R2R, 1 - use PWM
     bool flatAudioIn; // 0 - normal (deemphasized) audio input, 1 - flat audio (unfiltered) input
 } modem_demod_config_t;
@@ -66,6 +94,21 @@ typedef enum ModemPrefilter_e {
     PREFILTER_FLAT,
 } modem_prefilter_t;
 
+typedef struct ModemDemodParams_s {
+    modem_demod_type_t type;     // AFSK tone detector type
+    modem_prefilter_t prefilter; // input filter
+    float pllLockedTune;         // bit recovery PLL tuning coefficient when DCD is on
+    float pllNotLockedTune;      // bit recovery PLL tuning coefficient when DCD is off
+    uint16_t dcdMax;             // DCD pulse counter maximum value
+    uint16_t dcdThres;           // DCD pulse counter threshold
+    uint16_t dcdInc;             // DCD pulse counter increment on symbol change near PLL zero
+    uint16_t dcdDec;             // DCD pulse counter decrement on symbol change far from PLL zero
+    float dcdTune;               // DCD PLL tuning coefficient
+    int16_t markOffset;          // mark tone offset in Hz (AFSK only)
+    int16_t spaceOffset;         // space tone offset in Hz (AFSK only)
+    float slicerLevel;           // data slicer threshold relative to the tone energy, -1 to 1, 0 for the center. Positive favors space
+} modem_demod_params_t;
+
 /**
  * @brief Get measured signal level
  * @param modem Modem number
@@ -75,6 +118,16 @@ typedef enum ModemPrefilter_e {
  */
 void modem_get_signal_level(uint8_t modem, int8_t *peak, int8_t *valley, uint8_t *level);
 
+/**
+ * @brief Get measured signal level of a modem context
+ * @param *ctx Modem context
+ * @param modem Modem number
+ * @param *peak Output signal positive peak in %
+ * @param *valley Output signal negative peak in %
+ * @param *level Output signal level in %
+ */
+void modem_ctx_get_signal_level(const modem_ctx_t *ctx, uint8_t modem, int8_t *peak, int8_t *valley, uint8_t *level);
+
 /**
  * @brief Get current modem baudrate
  * @return Baudrate
@@ -87,6 +140,13 @@ float modem_get_baudrate(void);
  */
 uint8_t modem_get_demodulator_count(void);
 
+/**
+ * @brief Get count of demodulators running in parallel in a modem context
+ * @param *ctx Modem context
+ * @return Count of demodulators
+ */
+uint8_t modem_ctx_get_demodulator_count(const modem_ctx_t *ctx);
+
 /**
  * @brief Get prefilter type (preemphasis, deemphasis etc.) for given modem
  * @param modem Modem number
@@ -94,12 +154,27 @@ uint8_t modem_get_demodulator_count(void);
  */
 modem_prefilter_t modem_get_filter_type(uint8_t modem);
 
+/**
+ * @brief Get prefilter type for given modem of a modem context
+ * @param *ctx Modem context
+ * @param modem Modem number
+ * @return Filter type
+ */
+modem_prefilter_t modem_ctx_get_filter_type(const modem_ctx_t *ctx, uint8_t modem);
+
 /**
  * @brief Get current DCD state
  * @return 1 if channel busy, 0 if free
  */
 uint8_t modem_dcd_state(void);
 
+/**
+ * @brief Get current DCD state of a modem context
+ * @param *ctx Modem context
+ * @return 1 if channel busy, 0 if free
+ */
+uint8_t modem_ctx_dcd_state(const modem_ctx_t *ctx);
+
 /**
  * @brief Check if there is a TX test mode enabled
  * @return 1 if in TX test mode, 0 otherwise
@@ -144,10 +219,161 @@ void modem_transmit_stop(void);
 
 /**
  * @brief Initialize modem module
+ * @details Configures the default context from ModemConfig. The default context is used by all functions without a context argument,
+ * drives the DCD LED and shares its settings with the transmitter.
  */
 void modem_init(void);
 
+/**
+ * @brief Get the default modem context
+ * @return Default modem context
+ */
+modem_ctx_t *modem_get_default_ctx(void);
+
+/**
+ * @brief Create an independent receiver
+ * @details Each context has its own demodulators, DCD and AX.25 frame decoder with received frame buffer,
+ * so contexts can be fed from different threads or cores. It does not drive the DCD LED and has no transmitter.
+ * @param *config Modem configuration, copied to the context
+ * @return Modem context with default demodulators or NULL if out of memory
+ */
+modem_ctx_t *modem_ctx_create(const modem_demod_config_t *config);
+
+/**
+ * @brief Destroy a receiver created by modem_ctx_create()
+ * @param *ctx Modem context
+ */
+void modem_ctx_destroy(modem_ctx_t *ctx);
+
+/**
+ * @brief Get AX.25 receiver of a modem context, used to read received frames
+ * @param *ctx Modem context
+ * @return AX.25 receiver
+ */
+struct Ax25Rx_s *modem_ctx_get_rx(modem_ctx_t *ctx);
+
+/**
+ * @brief Get default demodulator parameters for current modem
+ * @param prefilter Input filter type
+ * @param *params Output demodulator parameters
+ * @attention Must be called after modem_init()
+ */
+void modem_get_default_demodulator(modem_prefilter_t prefilter, modem_demod_params_t *params);
+
+/**
+ * @brief Get default demodulator parameters for the modem of a context
+ * @param *ctx Modem context
+ * @param prefilter Input filter type
+ * @param *params Output demodulator parameters
+ */
+void modem_ctx_get_default_demodulator(const modem_ctx_t *ctx, modem_prefilter_t prefilter, modem_demod_params_t *params);
+
+/**
+ * @brief Replace demodulators running in parallel on the received signal
+ * @details All demodulators get the same input samples. Each of them has its own prefilter, PLL, DCD and tone settings
+ * and its own HDLC decoder. Frames are multiplexed by CRC, so a frame received by more than one demodulator is stored once.
+ * @param *params Demodulator parameters array
+ * @param count Number of demodulators, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @return True on success, false if count is out of range
+ * @attention Must be called after modem_init(), which sets up the default demodulators
+ */
+bool modem_set_demodulators(const modem_demod_params_t *params, uint8_t count);
+
+/**
+ * @brief Replace demodulators of a modem context
+ * @param *ctx Modem context
+ * @param *params Demodulator parameters array
+ * @param count Number of demodulators, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @return True on success, false if count is out of range
+ */
+bool modem_ctx_set_demodulators(modem_ctx_t *ctx, const modem_demod_params_t *params, uint8_t count);
+
+/**
+ * @brief Replace demodulators with a bank of demodulators at stepped tone offsets
+ * @details Each offset is added to both the mark and the space tone, e.g. -150, -100, -50, 0, 50, 100, 150 Hz
+ * for a 300 Bd HF signal that is not tuned exactly. All correlators share the input filter and its sample window.
+ * With a pre-selector, only the active correlators with the highest tone energy run on every sample; the others run once per symbol
+ * to measure their energy. Pre-selection works with the correlator only, other tone detector types always run.
+ * Received frame bitmaps and decoder statistics tell which offsets decode frames.
+ * @param *params Parameters shared by all demodulators, markOffset and spaceOffset are ignored
+ * @param *offsets Tone offsets in Hz
+ * @param count Number of offsets, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @param active Number of correlators kept running by the pre-selector, 0 to run all of them
+ * @return True on success, false if count is out of range
+ * @attention Must be called after modem_init()
+ */
+bool modem_set_offset_bank(const modem_demod_params_t *params, const int16_t *offsets, uint8_t count, uint8_t active);
+
+/**
+ * @brief Replace demodulators of a modem context with a bank of demodulators at stepped tone offsets
+ * @param *ctx Modem context
+ * @param *params Parameters shared by all demodulators, markOffset and spaceOffset are ignored
+ * @param *offsets Tone offsets in Hz
+ * @param count Number of offsets, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @param active Number of correlators kept running by the pre-selector, 0 to run all of them
+ * @return True on success, false if count is out of range
+ */
+bool modem_ctx_set_offset_bank(modem_ctx_t *ctx, const modem_demod_params_t *params, const int16_t *offsets, uint8_t count, uint8_t active);
+
+/**
+ * @brief Replace demodulators with data slicers sharing one tone detector
+ * @details Each slicer is a demodulator with the given parameters and its own slicer level, PLL, DCD and HDLC decoder.
+ * The tone detector and symbol low-pass filter run once for all of them, so a slicer costs much less than a demodulator.
+ * Slicers are numbered in the order of levels, so received frame bitmaps and decoder statistics tell which levels decode frames.
+ * A level of L balances a mark to space amplitude ratio of (1 + L) / (1 - L) for ideally separated tones. The short correlator
+ * windows leak one tone into the other, so small levels such as -0.2, -0.1, 0, 0.1, 0.2 already cover typical twist.
+ * Levels have no effect on the delay line detector.
+ * @param *params Parameters shared by all slicers, slicerLevel is ignored
+ * @param *levels Slicer levels, -1 to 1
+ * @param count Number of slicers, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @return True on success, false if count is out of range
+ * @attention Must be called after modem_init()
+ */
+bool modem_set_slicers(const modem_demod_params_t *params, const float *levels, uint8_t count);
+
+/**
+ * @brief Replace demodulators of a modem context with data slicers sharing one tone detector
+ * @param *ctx Modem context
+ * @param *params Parameters shared by all slicers, slicerLevel is ignored
+ * @param *levels Slicer levels, -1 to 1
+ * @param count Number of slicers, 1 to MODEM_MAX_DEMODULATOR_COUNT
+ * @return True on success, false if count is out of range
+ */
+bool modem_ctx_set_slicers(modem_ctx_t *ctx, const modem_demod_params_t *params, const float *levels, uint8_t count);
+
+/**
+ * @brief Demodulate one received sample
+ * @param sample Received sample, no more than 13 bits
+ * @param mVrms Input signal RMS level in mV
+ */
 void modem_decode(int16_t sample, uint16_t mVrms);
+
+/**
+ * @brief Demodulate a block of received samples
+ * @details Each sample is passed through all demodulators in one pass. DCD state and DCD LED are updated once per block.
+ * @param *samples Received samples, no more than 13 bits each
+ * @param n Number of samples
+ * @param mVrms Input signal RMS level in mV
+ */
+void modem_decode_block(const int16_t *samples, size_t n, uint16_t mVrms);
+
+/**
+ * @brief Demodulate one received sample in a modem context
+ * @param *ctx Modem context
+ * @param sample Received sample, no more than 13 bits
+ * @param mVrms Input signal RMS level in mV
+ */
+void modem_ctx_decode(modem_ctx_t *ctx, int16_t sample, uint16_t mVrms);
+
+/**
+ * @brief Demodulate a block of received samples in a modem context
+ * @param *ctx Modem context
+ * @param *samples Received samples, no more than 13 bits each
+ * @param n Number of samples
+ * @param mVrms Input signal RMS level in mV
+ */
+void modem_ctx_decode_block(modem_ctx_t *ctx, const int16_t *samples, size_t n, uint16_t mVrms);
+
 uint8_t modem_baudrate_timer_handler(void);
 
 #endif
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "APRSlib_port.h"
+#include "modem.h"
+#include "modem_pool.h"
+
+static const char *TAG = "modem_pool";
+
+typedef struct PoolTask_s {
+    struct PoolTask_s *next;
+    size_t n;          // number of samples
+    uint16_t mVrms;    // input signal RMS level
+    int16_t samples[]; // sample block
+} pool_task_t;
+
+typedef struct PoolChannel_s {
+    modem_ctx_t *ctx;
+    pthread_mutex_t lock; // protects task list and scheduled flag
+    pool_task_t *head;    // oldest pending block
+    pool_task_t *tail;    // newest pending block
+    bool scheduled;       // channel is in a worker queue or being decoded
+    uint8_t home;         // worker queue used when the channel becomes ready
+} pool_channel_t;
+
+typedef struct PoolWorker_s {
+    modem_pool_t *pool;
+    pthread_t thread;
+    pthread_mutex_t lock;                   // protects queue
+    uint8_t queue[MODEM_POOL_MAX_CHANNELS]; // ready channels, each channel is in at most one queue
+    uint8_t queueHead;                      // index of the oldest channel, taken first by the owner and by other workers
+    uint8_t queueCount;                     // number of queued channels
+    uint8_t index;
+} pool_worker_t;
+
+struct ModemPool_s {
+    pool_worker_t workers[MODEM_POOL_MAX_THREADS];
+    uint8_t threadCount;
+    pool_channel_t channels[MODEM_POOL_MAX_CHANNELS];
+    uint8_t channelCount;
+    pthread_mutex_t lock; // protects counters and stop flag
+    pthread_cond_t wake;  // signalled when a channel becomes ready
+    pthread_cond_t idle;  // signalled when all blocks are decoded
+    uint32_t ready;       // number of queued channels in all worker queues
+    uint32_t pending;     // number of submitted blocks not decoded yet
+    bool stop;
+};
+
+/**
+ * @brief Put ready channel in worker queue and wake up a sleeping worker
+ * @param *w Worker
+ * @param channel Channel number
+ */
+static void pushChannel(pool_worker_t *w, uint8_t channel) {
+    modem_pool_t *pool = w->pool;
+
+    pthread_mutex_lock(&w->lock);
+    w->queue[(w->queueHead + w->queueCount) % MODEM_POOL_MAX_CHANNELS] = channel;
+    w->queueCount++;
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->ready++;
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Take the oldest channel from worker queue
+ * @details The owner takes the oldest channel too, so a requeued busy channel goes behind the other channels of its worker
+ * @param *w Worker
+ * @return Channel number or -1 if queue is empty
+ */
+static int popChannel(pool_worker_t *w) {
+    int channel = -1;
+
+    pthread_mutex_lock(&w->lock);
+    if (w->queueCount > 0) {
+        channel = w->queue[w->queueHead];
+        w->queueHead = (w->queueHead + 1) % MODEM_POOL_MAX_CHANNELS;
+        w->queueCount--;
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    if (channel >= 0) {
+        pthread_mutex_lock(&w->pool->lock);
+        w->pool->ready--;
+        pthread_mutex_unlock(&w->pool->lock);
+    }
+
+    return channel;
+}
+
+/**
+ * @brief Find a ready channel, own queue first, then the other workers' queues
+ * @param *w Worker
+ * @return Channel number or -1 if there is no ready channel
+ */
+static int findChannel(pool_worker_t *w) {
+    int channel = popChannel(w);
+
+    for (uint8_t i = 1; (channel < 0) && (i < w->pool->threadCount); i++)
+        channel = popChannel(&w->pool->workers[(w->index + i) % w->pool->threadCount]);
+
+    return channel;
+}
+
+/**
+ * @brief Decode the oldest block of a channel and requeue the channel if it has more blocks
+ * @param *w Worker
+ * @param channel Channel number
+ */
+static void runChannel(pool_worker_t *w, uint8_t channel) {
+    pool_channel_t *ch = &w->pool->channels[channel];
+
+    pthread_mutex_lock(&ch->lock);
+    pool_task_t *task = ch->head; // a scheduled channel always has at least one block
+    ch->head = task->next;
+    if (ch->head == NULL)
+        ch->tail = NULL;
+    pthread_mutex_unlock(&ch->lock);
+
+    modem_ctx_decode_block(ch->ctx, task->samples, task->n, task->mVrms);
+    free(task);
+
+    pthread_mutex_lock(&ch->lock);
+    bool more = (ch->head != NULL);
+    if (!more)
+        ch->scheduled = false;
+    pthread_mutex_unlock(&ch->lock);
+
+    if (more) // keep it on this worker behind its other ready channels, idle workers will steal it if it waits
+        pushChannel(w, channel);
+
+    pthread_mutex_lock(&w->pool->lock);
+    if (--w->pool->pending == 0)
+        pthread_cond_broadcast(&w->pool->idle);
+    pthread_mutex_unlock(&w->pool->lock);
+}
+
+static void *workerThread(void *arg) {
+    pool_worker_t *w = (pool_worker_t *)arg;
+    modem_pool_t *pool = w->pool;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        bool stopping = pool->stop; // checked before taking work, blocks not decoded yet are dropped
+        pthread_mutex_unlock(&pool->lock);
+        if (stopping)
+            break;
+
+        int channel = findChannel(w);
+        if (channel >= 0) {
+            runChannel(w, channel);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while ((pool->ready == 0) && !pool->stop)
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        bool stop = pool->stop;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (stop)
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Stop worker threads
+ * @param *pool Pool
+ * @param started Number of running worker threads
+ */
+static void stopWorkers(modem_pool_t *pool, uint8_t started) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (uint8_t i = 0; i < started; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+}
+
+/**
+ * @brief Free pending blocks, synchronization objects and the pool itself
+ * @param *pool Pool with no running workers
+ */
+static void freePool(modem_pool_t *pool) {
+    for (uint8_t i = 0; i < pool->channelCount; i++) {
+        pool_channel_t *ch = &pool->channels[i];
+        while (ch->head != NULL) {
+            pool_task_t *next = ch->head->next;
+            free(ch->head);
+            ch->head = next;
+        }
+        pthread_mutex_destroy(&ch->lock);
+    }
+
+    for (uint8_t i = 0; i < pool->threadCount; i++)
+        pthread_mutex_destroy(&pool->workers[i].lock);
+
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+modem_pool_t *modem_pool_create(uint8_t threads) {
+    if ((threads == 0) || (threads > MODEM_POOL_MAX_THREADS))
+        return NULL;
+
+    modem_pool_t *pool = calloc(1, sizeof(modem_pool_t));
+    if (pool == NULL)
+        return NULL;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    pool->threadCount = threads; // set before starting, workers use it for stealing
+    for (uint8_t i = 0; i < threads; i++) {
+        pool_worker_t *w = &pool->workers[i];
+        w->pool = pool;
+        w->index = i;
+        pthread_mutex_init(&w->lock, NULL);
+    }
+
+    for (uint8_t i = 0; i < threads; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, workerThread, &pool->workers[i]) != 0) {
+            log_i(TAG, "failed to start worker %d", i);
+            stopWorkers(pool, i);
+            freePool(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+void modem_pool_destroy(modem_pool_t *pool) {
+    if (pool == NULL)
+        return;
+
+    stopWorkers(pool, pool->threadCount);
+    freePool(pool);
+}
+
+int modem_pool_add_channel(modem_pool_t *pool, modem_ctx_t *ctx) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->channelCount >= MODEM_POOL_MAX_CHANNELS) {
+        pthread_mutex_unlock(&pool->lock);
+        return -1;
+    }
+
+    uint8_t channel = pool->channelCount;
+    pool_channel_t *ch = &pool->channels[channel];
+    memset(ch, 0, sizeof(*ch));
+    ch->ctx = ctx;
+    ch->home = channel % pool->threadCount; // spread channels evenly, stealing takes care of the imbalance
+    pthread_mutex_init(&ch->lock, NULL);
+    pool->channelCount++;
+    pthread_mutex_unlock(&pool->lock);
+
+    return channel;
+}
+
+bool modem_pool_submit(modem_pool_t *pool, int channel, const int16_t *samples, size_t n, uint16_t mVrms) {
+    if (channel < 0)
+        return false;
+
+    pool_task_t *task = malloc(sizeof(pool_task_t) + n * sizeof(int16_t));
+    if (task == NULL)
+        return false;
+
+    task->next = NULL;
+    task->n = n;
+    task->mVrms = mVrms;
+    memcpy(task->samples, samples, n * sizeof(int16_t));
+
+    pthread_mutex_lock(&pool->lock);
+    if (channel >= pool->channelCount) // channels may be added while others are decoded
+    {
+        pthread_mutex_unlock(&pool->lock);
+        free(task);
+        return false;
+    }
+    pool->pending++;
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_channel_t *ch = &pool->channels[channel];
+
+    pthread_mutex_lock(&ch->lock);
+    if (ch->tail != NULL)
+        ch->tail->next = task;
+    else
+        ch->head = task;
+    ch->tail = task;
+    bool wasIdle = !ch->scheduled;
+    ch->scheduled = true;
+    pthread_mutex_unlock(&ch->lock);
+
+    if (wasIdle) // channel was not queued and not being decoded
+        pushChannel(&pool->workers[ch->home], channel);
+
+    return true;
+}
+
+void modem_pool_wait(modem_pool_t *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MODEM_POOL_H_
+#define MODEM_POOL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "modem.h"
+
+#define MODEM_POOL_MAX_THREADS  16 // maximum number of worker threads
+#define MODEM_POOL_MAX_CHANNELS 32 // maximum number of channels (modem contexts) in a pool
+
+/**
+ * @brief Multi-channel decoder running on a pool of worker threads
+ * @details Every submitted sample block is a task of its channel. A channel is queued on one worker at a time and decodes one block per turn,
+ * so the blocks of a channel are always decoded in order and never concurrently. A worker takes the oldest channel from its own queue
+ * and a channel with more blocks goes back to the end of it, so the channels of a worker take turns. A worker steals from the other
+ * workers when its queue is empty, so busy channels don't wait behind a single thread.
+ */
+typedef struct ModemPool_s modem_pool_t;
+
+/**
+ * @brief Create pool and start worker threads
+ * @param threads Number of worker threads, 1 to MODEM_POOL_MAX_THREADS
+ * @return Pool or NULL on failure
+ */
+modem_pool_t *modem_pool_create(uint8_t threads);
+
+/**
+ * @brief Stop worker threads and destroy pool
+ * @details Blocks being decoded are finished, blocks that were not decoded yet are dropped. Modem contexts are not destroyed.
+ * @param *pool Pool
+ */
+void modem_pool_destroy(modem_pool_t *pool);
+
+/**
+ * @brief Add channel to pool
+ * @param *pool Pool
+ * @param *ctx Modem context decoding this channel, must not be fed outside of the pool
+ * @return Channel number or -1 if there are already MODEM_POOL_MAX_CHANNELS channels
+ */
+int modem_pool_add_channel(modem_pool_t *pool, modem_ctx_t *ctx);
+
+/**
+ * @brief Queue a block of samples for decoding
+ * @details Samples are copied, so the buffer can be reused when this function returns
+ * @param *pool Pool
+ * @param channel Channel number returned by modem_pool_add_channel()
+ * @param *samples Received samples, no more than 13 bits each
+ * @param n Number of samples
+ * @param mVrms Input signal RMS level in mV
+ * @return True on success, false if channel is invalid or out of memory
+ */
+bool modem_pool_submit(modem_pool_t *pool, int channel, const int16_t *samples, size_t n, uint16_t mVrms);
+
+/**
+ * @brief Wait until all queued blocks are decoded
+ * @param *pool Pool
+ * @attention Read received frames of the channel contexts only after this function returns
+ */
+void modem_pool_wait(modem_pool_t *pool);
+
+#endif /* MODEM_POOL_H_ */
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "APRSlib_tables.h"
+#include "fir_engine.h"
+#include "resampler.h"
+
+#if (RESAMPLER_MAX_TAPS % FIR_ENGINE_TAPS_ALIGN) != 0
+#error "RESAMPLER_MAX_TAPS must be a multiple of FIR_ENGINE_TAPS_ALIGN"
+#endif
+
+#define TRANSITION_WIDTH 3.3f // Hamming window transition band width times filter length, relative to the sample rate
+
+/**
+ * @brief Greatest common divisor
+ * @param a First value
+ * @param b Second value
+ * @return Greatest common divisor of a and b
+ */
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Design the polyphase anti-aliasing filter
+ * @details Same formulas as the constant tables generated by tools/gen_tables.py
+ * @param *r Resampler state, design is filled
+ * @param inputRate Input sample rate in Hz
+ * @param low Lower of the input and output sample rates in Hz
+ * @param up Interpolation factor
+ * @param taps Taps per branch
+ */
+static void designFilter(resampler_t *r, uint32_t inputRate, float low, uint32_t up, uint32_t taps) {
+    // Hamming windowed sinc prototype at the upsampled rate, cutoff in cycles per upsampled sample
+    uint32_t len = taps * up;
+    float fc = 0.5f * low / ((float)inputRate * (float)up);
+
+    for (uint32_t p = 0; p < up; p++) {
+        float h[RESAMPLER_MAX_TAPS];
+        float sum = 0.f;
+
+        for (uint32_t k = 0; k < taps; k++) {
+            uint32_t j = p + k * up;
+            float t = (float)j - (float)(len - 1) / 2.f;
+            float x = (t == 0.f) ? 2.f * fc : sinf(2.f * (float)M_PI * fc * t) / ((float)M_PI * t);
+            h[k] = x * (0.54f - 0.46f * cosf(2.f * (float)M_PI * (float)j / (float)(len - 1)));
+            sum += h[k];
+        }
+
+        // normalize every branch to unity gain, so that no branch dependent ripple is added
+        for (uint32_t k = 0; k < taps; k++) {
+            long c = lroundf(32768.f * h[k] / sum);
+            if (c > INT16_MAX)
+                c = INT16_MAX;
+            else if (c < INT16_MIN)
+                c = INT16_MIN;
+            r->design[p * taps + taps - 1 - k] = (int16_t)c; // store reversed, so that the first coefficient multiplies the oldest sample
+        }
+    }
+    r->coeffs = r->design;
+}
+
+bool resampler_init(resampler_t *r, uint32_t inputRate, uint32_t outputRate) {
+    memset(r, 0, sizeof(*r));
+
+    if ((inputRate == 0) || (outputRate == 0))
+        return false;
+
+    uint32_t g = gcd(inputRate, outputRate);
+    uint32_t up = outputRate / g;
+    uint32_t down = inputRate / g;
+
+    r->up = 1;
+    r->down = 1;
+    if (up == down) // same rate, pass through
+        return true;
+
+    if ((up > UINT16_MAX) || (down > UINT16_MAX))
+        return false;
+
+    for (uint8_t i = 0; i < resampler_table_count; i++) {
+        const resampler_table_t *t = &resampler_tables[i];
+        if ((t->inputRate == inputRate) && (t->outputRate == outputRate) && (t->taps <= RESAMPLER_MAX_TAPS)) {
+            r->coeffs = t->coeffs;
+            r->taps = t->taps;
+            break;
+        }
+    }
+
+    if (r->coeffs == NULL) {
+        // transition band from 1/4 to 3/4 of the lower rate, filter length counted at the input rate
+        float low = (float)((inputRate < outputRate) ? inputRate : outputRate);
+        uint32_t taps = (uint32_t)ceilf(TRANSITION_WIDTH * (float)inputRate / (0.5f * low));
+        taps = (taps + FIR_ENGINE_TAPS_ALIGN - 1) / FIR_ENGINE_TAPS_ALIGN * FIR_ENGINE_TAPS_ALIGN;
+        if ((taps > RESAMPLER_MAX_TAPS) || ((taps * up) > RESAMPLER_MAX_COEFFS))
+            return false;
+
+        designFilter(r, inputRate, low, up, taps);
+        r->taps = taps;
+    }
+
+    r->up = up;
+    r->down = down;
+
+    // start with zeroed history, first output at the first input sample
+    r->fill = r->taps - 1;
+    r->next = r->taps - 1;
+    return true;
+}
+
+size_t resampler_process(resampler_t *r, const int16_t *in, size_t n, int16_t *out) {
+    size_t k = 0;
+
+    if (r->taps == 0) {
+        if (out != in)
+            memmove(out, in, n * sizeof(*in));
+        return n;
+    }
+
+    while (n > 0) {
+        size_t chunk = (sizeof(r->buffer) / sizeof(*r->buffer)) - r->fill;
+        if (chunk > n)
+            chunk = n;
+
+        memcpy(&r->buffer[r->fill], in, chunk * sizeof(*in)); // output never overtakes consumed input when downsampling, so in-place use is safe
+        r->fill += chunk;
+        in += chunk;
+        n -= chunk;
+
+        while (r->next < r->fill) {
+            out[k++] = fir_dotprod_s16(&r->coeffs[r->phase * r->taps], &r->buffer[r->next + 1 - r->taps], r->taps) >> 15;
+
+            // advance by M/L input samples
+            uint32_t phase = (uint32_t)r->phase + r->down;
+            r->next += phase / r->up;
+            r->phase = phase % r->up;
+        }
+
+        // move the samples still needed to the beginning of the buffer
+        uint16_t start = r->next + 1 - r->taps;
+        memmove(r->buffer, &r->buffer[start], (r->fill - start) * sizeof(*r->buffer));
+        r->fill -= start;
+        r->next -= start;
+    }
+
+    return k;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RESAMPLER_MAX_TAPS   64   // maximum taps per polyphase branch, must be a multiple of FIR_ENGINE_TAPS_ALIGN
+#define RESAMPLER_MAX_COEFFS 1024 // maximum prototype filter length (interpolation factor * taps per branch)
+#define RESAMPLER_CHUNK      128  // input samples copied to the work buffer at once
+
+/**
+ * @brief Streaming rational L/M resampler
+ * @details The input is conceptually upsampled by L, low-pass filtered and downsampled by M. Only the filter branch (polyphase) needed
+ * for each output sample is evaluated, so every output costs a single contiguous dot product over the input history. L and M are the
+ * output and input sample rates reduced by their greatest common divisor, e.g. 44100 Hz to 9600 Hz is L=32, M=147.
+ * Filter coefficients of common sound card rates are constant tables (see APRSlib_tables.h), other rates are designed once at
+ * initialization. Processing is integer only.
+ */
+typedef struct Resampler_s {
+    const int16_t *coeffs;                                // polyphase branches, taps coefficients each, oldest sample first
+    int16_t design[RESAMPLER_MAX_COEFFS];                 // filter designed at initialization, when there is no table for the rates
+    int16_t buffer[RESAMPLER_MAX_TAPS + RESAMPLER_CHUNK]; // sample history followed by new samples, oldest first
+    uint16_t fill;                                        // number of samples in buffer
+    uint16_t next;                                        // buffer index of the newest sample used by the next output
+    uint16_t phase;                                       // polyphase branch of the next output, 0 to up - 1
+    uint16_t up;                                          // interpolation factor L
+    uint16_t down;                                        // decimation factor M
+    uint8_t taps;                                         // taps per branch, a multiple of 8
+} resampler_t;
+
+/**
+ * @brief Initialize resampler
+ * @details The anti-aliasing filter passes up to 1/4 and stops from 3/4 of the lower of the two sample rates, which keeps the
+ * 300/1200 Bd tone bands intact for a 9600 Hz output rate.
+ * @param *r Resampler state
+ * @param inputRate Input sample rate in Hz
+ * @param outputRate Output sample rate in Hz
+ * @return True on success, false if the rate ratio needs a longer filter than RESAMPLER_MAX_TAPS or RESAMPLER_MAX_COEFFS allow
+ */
+bool resampler_init(resampler_t *r, uint32_t inputRate, uint32_t outputRate);
+
+/**
+ * @brief Resample a block of samples
+ * @details At most (n * up) / down + 1 output samples are produced.
+ * @param *r Resampler state
+ * @param *in Input samples
+ * @param n Number of input samples
+ * @param *out Output samples, can be the same buffer as in when the output rate is not higher than the input rate
+ * @return Number of output samples
+ */
+size_t resampler_process(resampler_t *r, const int16_t *in, size_t n, int16_t *out);
+
+#endif /* RESAMPLER_H_ */
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "decimator.h"
+#include "resampler.h"
+#include "rx_frontend.h"
+
+#define DC_SHIFT 7 // DC estimate time constant, 2^DC_SHIFT samples
+
+// AGC configuration
+#define AGC_TARGET_RMS 410                                 // target RMS level (-14 dBFS at 12-bit input)
+#define AGC_ATTACK     655                                 // fast attack rate, Q15 (0.02)
+#define AGC_RELEASE    33                                  // slow release rate, Q15 (0.001)
+#define AGC_MAX_GAIN   (10 << RX_FRONTEND_GAIN_BITS)       // 10
+#define AGC_MIN_GAIN   ((1 << RX_FRONTEND_GAIN_BITS) / 10) // 0.1
+
+/**
+ * @brief Integer square root
+ * @param x Input value
+ * @return floor(sqrt(x))
+ */
+static uint32_t isqrt(uint32_t x) {
+    uint32_t root = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+
+    while (bit > x)
+        bit >>= 2;
+
+    while (bit) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief Update AGC gain with the mean square level of the last block
+ * @param *fe Front end state
+ * @param meanSquare Mean square of output samples, before decimation
+ */
+static void updateAgc(rx_frontend_t *fe, uint32_t meanSquare) {
+    int32_t rms = isqrt(meanSquare);
+    if (rms == 0)
+        rms = 1;
+
+    // gain = gain + gain * rate * (target / rms - 1)
+    int32_t rate = (rms > AGC_TARGET_RMS) ? AGC_RELEASE : AGC_ATTACK;
+    fe->gain += ((int64_t)fe->gain * rate * (AGC_TARGET_RMS - rms)) / ((int64_t)rms << 15);
+
+    if (fe->gain > AGC_MAX_GAIN)
+        fe->gain = AGC_MAX_GAIN;
+    else if (fe->gain < AGC_MIN_GAIN)
+        fe->gain = AGC_MIN_GAIN;
+}
+
+bool rx_frontend_init(rx_frontend_t *fe, uint32_t inputRate, uint32_t outputRate) {
+    memset(fe, 0, sizeof(*fe));
+    fe->gain = 1 << RX_FRONTEND_GAIN_BITS;
+
+    if ((outputRate > 0) && ((inputRate % outputRate) == 0) && ((inputRate / outputRate) <= 4))
+        return decimator_init(&fe->decimator, inputRate / outputRate);
+
+    fe->resample = true;
+    return resampler_init(&fe->resampler, inputRate, outputRate);
+}
+
+size_t rx_frontend_process(rx_frontend_t *fe, const int16_t *in, size_t n, int16_t *out) {
+    int16_t chunk[DECIMATOR_CHUNK];
+    uint64_t energy = 0;
+    size_t k = 0;
+    size_t c = 0;
+
+    if ((n > 0) && !fe->dcValid) { // start from the first sample to avoid a long settling time
+        fe->dc = (int32_t)in[0] * 65536;
+        fe->dcValid = true;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = in[i];
+
+        fe->dc += (int32_t)(((int64_t)x * 65536 - fe->dc) >> DC_SHIFT); // one-pole DC estimate, Q16 difference may exceed 32 bits
+        x -= (fe->dc + 0x8000) >> 16;
+
+        if (x > INT16_MAX) // full scale steps after DC removal, keeps the gain product within 32 bits
+            x = INT16_MAX;
+        else if (x < -INT16_MAX)
+            x = -INT16_MAX;
+        x = (x * fe->gain) >> RX_FRONTEND_GAIN_BITS; // apply AGC gain
+        if (x > RX_FRONTEND_OUT_MAX)
+            x = RX_FRONTEND_OUT_MAX;
+        else if (x < -RX_FRONTEND_OUT_MAX)
+            x = -RX_FRONTEND_OUT_MAX;
+
+        energy += (uint32_t)(x * x);
+
+        chunk[c++] = x;
+        if ((c == DECIMATOR_CHUNK) || (i == (n - 1))) {
+            if (fe->resample)
+                k += resampler_process(&fe->resampler, chunk, c, &out[k]);
+            else
+                k += decimator_process(&fe->decimator, chunk, c, &out[k]);
+            c = 0;
+        }
+    }
+
+    if (n > 0)
+        updateAgc(fe, energy / n);
+
+    return k;
+}
+
+int32_t rx_frontend_get_gain(const rx_frontend_t *fe) {
+    return fe->gain;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+ * * Project Site: https://github.com/hiperiondev/APRSlib *
+ *
+ * This is based on other projects:
+ *    VP-Digi: https://github.com/sq8vps/vp-digi
+ *    ESP32APRS: https://github.com/nakhonthai/ESP32APRS_Audio
+ *    LibAPRS: https://github.com/markqvist/LibAPRS
+ *
+ *    please contact their authors for more information.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RX_FRONTEND_H_
+#define RX_FRONTEND_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "decimator.h"
+#include "resampler.h"
+
+#define RX_FRONTEND_GAIN_BITS 12   // AGC gain fractional bits
+#define RX_FRONTEND_OUT_MAX   4095 // AGC output limit, 13 bits as required by the demodulator
+
+/**
+ * @brief Integer receive front end: DC removal, AGC and sample rate conversion
+ * @details Takes raw ADC samples and produces demodulator input samples. Samples stay integer: the DC estimate is Q16, the AGC gain
+ * has RX_FRONTEND_GAIN_BITS fractional bits with Q15 attack and release rates, and the rate conversion filters use Q15 coefficients
+ * with 32-bit accumulators.
+ * Integer ratios up to 4 use the fixed decimation filters, any other rate (e.g. 44100 or 48000 Hz sound card input) uses the rational
+ * resampler.
+ */
+typedef struct RxFrontend_s {
+    int32_t dc;    // input DC offset estimate, Q16
+    bool dcValid;  // DC estimate initialized with the first sample
+    int32_t gain;  // AGC gain, RX_FRONTEND_GAIN_BITS fractional bits
+    bool resample; // rational resampler used instead of the decimator
+    union {
+        decimator_t decimator; // integer decimation to the demodulator sample rate
+        resampler_t resampler; // rational resampling to the demodulator sample rate
+    };
+} rx_frontend_t;
+
+/**
+ * @brief Initialize front end
+ * @param *fe Front end state
+ * @param inputRate Input (ADC) sample rate in Hz
+ * @param outputRate Demodulator sample rate in Hz
+ * @return True on success, false if the rate conversion is not supported
+ */
+bool rx_frontend_init(rx_frontend_t *fe, uint32_t inputRate, uint32_t outputRate);
+
+/**
+ * @brief Process a block of ADC samples
+ * @details AGC gain is updated once per block from the block RMS level, so blocks should be a few milliseconds long.
+ * @param *fe Front end state
+ * @param *in Raw ADC samples
+ * @param n Number of input samples
+ * @param *out Output samples, room for (n * outputRate) / inputRate + 1 samples. Can be the same buffer as in when the output rate is not
+ * higher than the input rate
+ * @return Number of output samples
+ */
+size_t rx_frontend_process(rx_frontend_t *fe, const int16_t *in, size_t n, int16_t *out);
+
+/**
+ * @brief Get current AGC gain
+ * @param *fe Front end state
+ * @return Gain with RX_FRONTEND_GAIN_BITS fractional bits
+ */
+int32_t rx_frontend_get_gain(const rx_frontend_t *fe);
+
+#endif /* RX_FRONTEND_H_ */
@@ -0,0 +1,350 @@
+#!/usr/bin/env python3
+#
+# Copyright 2025 Emiliano Augusto Gonzalez (egonzalez . hiperion @ gmail . com))
+# * Project Site: https://github.com/hiperiondev/APRSlib *
+#
+# This is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This software is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this software; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+"""Generate APRSlib_tables.c, the constant tables declared in APRSlib_tables.h.
+
+Tone detector and resampler tables are calculated with the same single precision formulas as the run time fallbacks
+in modem/modem.c (calculateToneSet()) and modem/resampler.c (designFilter()), so a table and a run time calculation
+give the same coefficients. Every intermediate result is rounded to float like the C code does.
+"""
+
+import math
+import struct
+import sys
+
+# keep in sync with configure() in modem/modem.c: baudrate, samples per symbol, (mark, space) tone pairs
+MODEMS = [
+    (1200, 8, [(1200, 2200), (1300, 2100)]),  # Bell 202, V.23
+    (300, 32, [(1600, 1800)]),
+]
+
+# keep in sync with modem/resampler.h, modem/fir_engine.h and APRSlib_tables.h
+RESAMPLER_MAX_TAPS = 64
+RESAMPLER_MAX_COEFFS = 1024
+FIR_ENGINE_TAPS_ALIGN = 8
+TRANSITION_WIDTH = 3.3
+TONE_MAX_N = 32
+TONE_SDFT_MAX_PERIOD = 192
+DAC_SINE_LEN = 512
+
+# sound card sample rates and demodulator sample rates (9600 Hz for AFSK, 38400 Hz for 9600 Bd)
+# integer ratios up to 4 are handled by the decimator and need no table
+INPUT_RATES = [11025, 16000, 22050, 24000, 32000, 44100, 48000]
+DEMOD_RATES = [9600, 38400]
+
+FX25_RS_FCR = 1
+FX25_PARITY_SIZES = [16, 32, 64]
+GF_POLY = 0x11D
+
+CRC_CCIT_POLY = 0x8408  # CRC-CCITT, reflected
+CRC_CCIT_MAX_SLICES = 8
+
+# keep in sync with APRSlib_tables.h
+HDLC_STEP_FLAG = 0x01
+HDLC_STEP_ABORT = 0x02
+HDLC_STEP_TAIL_FLAG = 0x04
+HDLC_STEP_TAIL_ABORT = 0x08
+
+
+def f32(x):
+    """Round to single precision."""
+    return struct.unpack("<f", struct.pack("<f", x))[0]
+
+
+def cosf(x):
+    return f32(math.cos(x))
+
+
+def sinf(x):
+    return f32(math.sin(x))
+
+
+def trunc(x):
+    """Float to integer conversion of C, rounding toward zero."""
+    return int(x)
+
+
+def lroundf(x):
+    return int(math.floor(abs(x) + 0.5)) * (1 if x >= 0 else -1)
+
+
+def array(values, indent, per_line=20):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "{\n" + "\n".join(lines) + "\n" + indent[:-4] + "}"
+
+
+def tone_set(baud, n, mark, space):
+    pi2 = f32(2.0 * f32(3.1416))
+    t = {"lo_i": [], "lo_q": [], "hi_i": [], "hi_q": []}
+
+    for i in range(n):
+        for freq, i_key, q_key in ((mark, "lo_i", "lo_q"), (space, "hi_i", "hi_q")):
+            arg = f32(f32(f32(f32(pi2 * i) / n) * freq) / baud)
+            t[i_key].append(trunc(f32(4095.0 * cosf(arg))))
+            t[q_key].append(trunc(f32(4095.0 * sinf(arg))))
+
+    fs = n * baud
+    t["survey_mark"] = trunc(f32(f32(2.0 * 16384.0) * cosf(f32(f32(pi2 * mark) / fs))))
+    t["survey_space"] = trunc(f32(f32(2.0 * 16384.0) * cosf(f32(f32(pi2 * space) / fs))))
+
+    period = fs // math.gcd(fs, math.gcd(mark, space))
+    if period > TONE_SDFT_MAX_PERIOD:
+        period = 0
+    t["period"] = period
+    for key in ("sdft_lo_i", "sdft_lo_q", "sdft_hi_i", "sdft_hi_q"):
+        t[key] = []
+    for i in range(period):
+        for freq, i_key, q_key in ((mark, "sdft_lo_i", "sdft_lo_q"), (space, "sdft_hi_i", "sdft_hi_q")):
+            arg = f32(f32(f32(pi2 * i) * freq) / fs)
+            t[i_key].append(trunc(f32(4095.0 * cosf(arg))))
+            t[q_key].append(trunc(f32(4095.0 * sinf(arg))))
+    return t
+
+
+def resampler(input_rate, output_rate):
+    g = math.gcd(input_rate, output_rate)
+    up = output_rate // g
+    down = input_rate // g
+
+    low = f32(min(input_rate, output_rate))
+    taps = math.ceil(f32(f32(f32(TRANSITION_WIDTH) * input_rate) / f32(0.5 * low)))
+    taps = (taps + FIR_ENGINE_TAPS_ALIGN - 1) // FIR_ENGINE_TAPS_ALIGN * FIR_ENGINE_TAPS_ALIGN
+    if (taps > RESAMPLER_MAX_TAPS) or ((taps * up) > RESAMPLER_MAX_COEFFS):
+        return None
+
+    length = taps * up
+    fc = f32(f32(0.5 * low) / f32(f32(input_rate) * up))
+    pi = f32(math.pi)
+    coeffs = [0] * length
+
+    for p in range(up):
+        h = []
+        total = f32(0.0)
+        for k in range(taps):
+            j = p + k * up
+            t = f32(f32(j) - f32(f32(length - 1) / 2.0))
+            if t == 0.0:
+                x = f32(2.0 * fc)
+            else:
+                x = f32(sinf(f32(f32(f32(2.0 * pi) * fc) * t)) / f32(pi * t))
+            w = f32(f32(0.54) - f32(f32(0.46) * cosf(f32(f32(f32(2.0 * pi) * j) / f32(length - 1)))))
+            h.append(f32(x * w))
+            total = f32(total + h[k])
+
+        for k in range(taps):
+            c = lroundf(f32(f32(32768.0 * h[k]) / total))
+            c = max(-32768, min(32767, c))
+            coeffs[p * taps + taps - 1 - k] = c  # reversed, oldest sample first
+    return up, down, taps, coeffs
+
+
+def rs_generator(parity):
+    exp = [0] * 255
+    x = 1
+    for i in range(255):
+        exp[i] = x
+        x <<= 1
+        if x & 0x100:
+            x ^= GF_POLY
+    log = [0] * 256
+    for i in range(255):
+        log[exp[i]] = i
+
+    def mul(a, b):
+        if (a == 0) or (b == 0):
+            return 0
+        return exp[(log[a] + log[b]) % 255]
+
+    gen = [1]
+    for i in range(parity):
+        root = [1, exp[i + FX25_RS_FCR]]
+        out = [0] * (len(gen) + 1)
+        for a in range(len(gen)):
+            for b in range(2):
+                out[a + b] ^= mul(gen[a], root[b])
+        gen = out
+    return gen
+
+
+def hdlc_step(ones, byte):
+    """Deframe 8 bits, bit 0 first, after the given number of ones (7 meaning 7 or more), like ax25_rx_bit_parse()."""
+    head, head_count, tail, tail_count, events = 0, 0, 0, 0, 0
+    aborted = False  # last event was an abort and no data followed, further aborts change nothing
+    for j in range(8):
+        bit = (byte >> j) & 1
+        if bit:
+            ones = min(ones + 1, 7)
+            event = HDLC_STEP_ABORT if ones == 7 else 0
+        else:
+            event = HDLC_STEP_FLAG if ones == 6 else 0
+            stuffed = ones >= 5
+            ones = 0
+            if stuffed and not event:
+                continue
+
+        if event == 0:  # data bit
+            aborted = False
+            if events:
+                tail |= bit << tail_count
+                tail_count += 1
+            else:
+                head |= bit << head_count
+                head_count += 1
+        elif aborted:
+            pass
+        elif events == 0:
+            events = event
+            aborted = event == HDLC_STEP_ABORT
+        elif events == HDLC_STEP_FLAG:  # flag at bit 0, then a flag or an abort at bit 7
+            events |= HDLC_STEP_TAIL_FLAG if event == HDLC_STEP_FLAG else HDLC_STEP_TAIL_ABORT
+            aborted = event == HDLC_STEP_ABORT
+        else:
+            raise ValueError("more HDLC events than a table entry holds, ones %d byte %02X" % (ones, byte))
+    return head, tail, head_count | (tail_count << 4), events | (ones << 4)
+
+
+def crc_ccit_slices():
+    table = []
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ CRC_CCIT_POLY if crc & 1 else crc >> 1
+        table.append(crc)
+    slices = [table]
+    for _ in range(CRC_CCIT_MAX_SLICES - 1):
+        slices.append([(c >> 8) ^ table[c & 0xFF] for c in slices[-1]])
+    return slices
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: gen_tables.py <output.c>")
+
+    out = []
+    out.append("// Generated by tools/gen_tables.py, do not edit")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append('#include "APRSlib_tables.h"')
+    out.append("")
+    out.append("#if (TONE_MAX_N != %d) || (TONE_SDFT_MAX_PERIOD != %d) || (DAC_SINE_LEN != %d)" % (TONE_MAX_N, TONE_SDFT_MAX_PERIOD, DAC_SINE_LEN))
+    out.append('#error "tools/gen_tables.py is out of sync with APRSlib_tables.h"')
+    out.append("#endif")
+    out.append("#if (HDLC_STEP_FLAG != %d) || (HDLC_STEP_ABORT != %d) || (HDLC_STEP_TAIL_FLAG != %d) || (HDLC_STEP_TAIL_ABORT != %d)"
+               % (HDLC_STEP_FLAG, HDLC_STEP_ABORT, HDLC_STEP_TAIL_FLAG, HDLC_STEP_TAIL_ABORT))
+    out.append('#error "tools/gen_tables.py is out of sync with APRSlib_tables.h"')
+    out.append("#endif")
+    out.append("")
+
+    # tone detectors
+    out.append("const tone_set_t tone_tables[] = {")
+    count = 0
+    for baud, n, tones in MODEMS:
+        for mark, space in tones:
+            t = tone_set(baud, n, mark, space)
+            ind = " " * 8
+            out.append("    {")
+            out.append("%s.markFreq = %d.f," % (ind, mark))
+            out.append("%s.spaceFreq = %d.f," % (ind, space))
+            out.append("%s.baudRate = %d.f," % (ind, baud))
+            out.append("%s.N = %d," % (ind, n))
+            for name, key in (("coeffHiI", "hi_i"), ("coeffLoI", "lo_i"), ("coeffHiQ", "hi_q"), ("coeffLoQ", "lo_q")):
+                out.append("%s.%s = %s," % (ind, name, array(t[key], ind + "    ")))
+            if t["period"] > 0:
+                for name, key in (("sdftHiI", "sdft_hi_i"), ("sdftLoI", "sdft_lo_i"), ("sdftHiQ", "sdft_hi_q"), ("sdftLoQ", "sdft_lo_q")):
+                    out.append("%s.%s = %s," % (ind, name, array(t[key], ind + "    ")))
+            out.append("%s.sdftPeriod = %d," % (ind, t["period"]))
+            out.append("%s.surveyMark = %d," % (ind, t["survey_mark"]))
+            out.append("%s.surveySpace = %d," % (ind, t["survey_space"]))
+            out.append("    },")
+            count += 1
+    out.append("};")
+    out.append("")
+    out.append("const uint8_t tone_table_count = %d;" % count)
+    out.append("")
+
+    # resampler polyphase filters
+    entries = []
+    for output_rate in DEMOD_RATES:
+        for input_rate in INPUT_RATES:
+            if (input_rate < output_rate) or (input_rate % output_rate == 0 and input_rate // output_rate <= 4):
+                continue
+            r = resampler(input_rate, output_rate)
+            if r is None:
+                continue
+            up, down, taps, coeffs = r
+            name = "resampler%uto%u" % (input_rate, output_rate)
+            out.append("// %u Hz to %u Hz, L=%u, M=%u, %u taps per branch" % (input_rate, output_rate, up, down, taps))
+            out.append("static const int16_t %s[%u] = %s;" % (name, len(coeffs), array(coeffs, "    ", 16)))
+            out.append("")
+            entries.append("    { .inputRate = %u, .outputRate = %u, .up = %u, .down = %u, .taps = %u, .coeffs = %s },"
+                           % (input_rate, output_rate, up, down, taps, name))
+    out.append("const resampler_table_t resampler_tables[] = {")
+    out.extend(entries)
+    out.append("};")
+    out.append("")
+    out.append("const uint8_t resampler_table_count = %d;" % len(entries))
+    out.append("")
+
+    # FX.25 Reed-Solomon generator polynomials, highest degree first
+    for parity in FX25_PARITY_SIZES:
+        gen = rs_generator(parity)
+        out.append("const lwfecrs_t fx25_rs%d = {" % parity)
+        out.append("    .generator = %s," % array(gen, "        ", 16))
+        out.append("    .T = %d," % parity)
+        out.append("    .fcr = %d," % FX25_RS_FCR)
+        out.append("};")
+        out.append("")
+
+    # DAC sine, first quarter of the period, offset binary
+    sine = [int(127.5 + 127.5 * math.sin(2.0 * math.pi * i / DAC_SINE_LEN) + 0.5) for i in range(DAC_SINE_LEN // 4)]
+    out.append("const uint8_t sin_table[DAC_SINE_LEN / 4] = %s;" % array(sine, "    ", 26))
+    out.append("")
+
+    # bit order reversal of a byte, for bit-serial data sent LSB first
+    reverse = [int("{:08b}".format(i)[::-1], 2) for i in range(256)]
+    out.append("const uint8_t bit_reverse_table[256] = %s;" % array(reverse, "    ", 16))
+    out.append("")
+
+    # HDLC deframer steps, 8 received bits at once
+    steps = ["{ %d, %d, 0x%02X, 0x%02X }" % hdlc_step(ones, byte) for ones in range(8) for byte in range(256)]
+    out.append("const hdlc_step_t hdlc_step_table[8 * 256] = %s;" % array(steps, "    ", 8))
+    out.append("")
+
+    # CRC-CCITT slice-by-N tables, crc_ccit_table in ax25_fx25/crc-ccit.c is slice 0
+    slices = crc_ccit_slices()
+    out.append("const uint16_t crc_ccit_slice_table[CRC_CCIT_SLICES - 1][256] = {")
+    for n in range(1, CRC_CCIT_MAX_SLICES):
+        if n == 4:
+            out.append("#if CRC_CCIT_SLICES > 4")
+        out.append("    %s," % array(["0x%04x" % c for c in slices[n]], "        ", 16))
+    out.append("#endif")
+    out.append("};")
+    out.append("")
+
+    with open(sys.argv[1], "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
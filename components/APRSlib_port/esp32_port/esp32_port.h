@@ -42,8 +42,6 @@
 #define port_TaskHandle_t      TaskHandle_t
 #define port_SemaphoreHandle_t SemaphoreHandle_t
 #define log_i                  ESP_LOGI
-#define __disable_irq()        // TODO: implement
-#define __enable_irq()         // TODO: implement
 #define giveSemaphore()                                                                                                                                        \
     if (xI2CSemaphore == NULL) {                                                                                                                               \
         xI2CSemaphore = xSemaphoreCreateMutex();                                                                                                               \